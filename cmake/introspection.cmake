@@ -192,6 +192,21 @@ if(NOT MSVC)
   )
   set(ENABLE_AVX2 ${HAVE_AVX2})
 
+  # Check for AVX-512 intrinsics.
+  set(AVX512_CXXFLAGS -mavx512f)
+  check_cxx_source_compiles_with_flags("${AVX512_CXXFLAGS}" "
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_set1_epi32(1);
+      l = _mm512_ternarylogic_epi32(_mm512_ror_epi32(l, 7), l, l, 0x96);
+      return _mm512_reduce_add_epi32(l);
+    }
+    " HAVE_AVX512
+  )
+  set(ENABLE_AVX512 ${HAVE_AVX512})
+
   # Check for x86 SHA-NI intrinsics.
   set(X86_SHANI_CXXFLAGS -msse4 -msha)
   check_cxx_source_compiles_with_flags("${X86_SHANI_CXXFLAGS}" "
@@ -12,6 +12,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+#include <bit>
 #include <limits>
 
 using util::ContainsNoNUL;
@@ -37,6 +39,9 @@ static const int8_t mapBase58[256] = {
     -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
 };
 
+/** Largest power of 58 that fits in 32 bits, used as the limb base while encoding. */
+static constexpr uint32_t BASE58_POW5{58 * 58 * 58 * 58 * 58};
+
 [[nodiscard]] static bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch, int max_ret_len)
 {
     // Skip leading spaces.
@@ -44,45 +49,56 @@ static const int8_t mapBase58[256] = {
         psz++;
     // Skip and count leading '1's.
     int zeroes = 0;
-    int length = 0;
     while (*psz == '1') {
         zeroes++;
         if (zeroes > max_ret_len) return false;
         psz++;
     }
-    // Allocate enough space in big-endian base256 representation.
-    int size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
+    // Accumulate the number in base 2^32 limbs, least significant first. Up to 5 characters are
+    // folded in per pass over the limbs, as 58^5 * 2^32 still fits in 64 bits.
+    std::vector<uint32_t> limbs;
+    limbs.reserve(strlen(psz) * 733 / 4000 + 1); // log(58) / log(2^32), rounded up.
     static_assert(std::size(mapBase58) == 256, "mapBase58.size() should be 256"); // guarantee not out of range
     while (*psz && !IsSpace(*psz)) {
-        // Decode base58 character
-        int carry = mapBase58[(uint8_t)*psz];
-        if (carry == -1)  // Invalid b58 character
-            return false;
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
+        // Decode up to 5 base58 characters
+        uint64_t carry = 0;
+        uint64_t mul = 1;
+        for (int i = 0; i < 5 && *psz && !IsSpace(*psz); ++i, ++psz) {
+            int digit = mapBase58[(uint8_t)*psz];
+            if (digit == -1) // Invalid b58 character
+                return false;
+            carry = carry * 58 + digit;
+            mul *= 58;
+        }
+        // Apply "limbs = limbs * 58^n + carry".
+        for (uint32_t& limb : limbs) {
+            carry += mul * limb;
+            limb = static_cast<uint32_t>(carry);
+            carry >>= 32;
         }
-        assert(carry == 0);
-        length = i;
+        assert((carry >> 32) == 0);
+        if (carry != 0) limbs.push_back(static_cast<uint32_t>(carry));
+        // Number of significant bytes so far.
+        const int length = limbs.empty() ? 0 : (limbs.size() - 1) * 4 + (std::bit_width(limbs.back()) + 7) / 8;
         if (length + zeroes > max_ret_len) return false;
-        psz++;
     }
     // Skip trailing spaces.
     while (IsSpace(*psz))
         psz++;
     if (*psz != 0)
         return false;
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
-    // Copy result into output vector.
-    vch.reserve(zeroes + (b256.end() - it));
+    // Copy result into output vector, skipping leading zero bytes of the top limb.
     vch.assign(zeroes, 0x00);
-    while (it != b256.end())
-        vch.push_back(*(it++));
+    vch.reserve(zeroes + limbs.size() * 4);
+    bool leading = true;
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            const unsigned char byte = (*it >> shift) & 0xff;
+            if (leading && byte == 0) continue;
+            leading = false;
+            vch.push_back(byte);
+        }
+    }
     return true;
 }
 
@@ -90,31 +106,44 @@ std::string EncodeBase58(Span<const unsigned char> input)
 {
     // Skip & count leading zeroes.
     int zeroes = 0;
-    int length = 0;
     while (input.size() > 0 && input[0] == 0) {
         input = input.subspan(1);
         zeroes++;
     }
-    // Allocate enough space in big-endian base58 representation.
-    int size = input.size() * 138 / 100 + 1; // log(256) / log(58), rounded up.
-    std::vector<unsigned char> b58(size);
-    // Process the bytes.
+    // Accumulate the number in base 58^5 limbs, least significant first. Up to 4 bytes are folded
+    // in per pass over the limbs, as 2^32 * 58^5 still fits in 64 bits.
+    std::vector<uint32_t> limbs;
+    limbs.reserve(input.size() * 138 / 500 + 1); // log(256) / log(58^5), rounded up.
     while (input.size() > 0) {
-        int carry = input[0];
-        int i = 0;
-        // Apply "b58 = b58 * 256 + ch".
-        for (std::vector<unsigned char>::reverse_iterator it = b58.rbegin(); (carry != 0 || i < length) && (it != b58.rend()); it++, i++) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
+        const size_t n = std::min<size_t>(4, input.size());
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            carry = (carry << 8) | input[i];
+        }
+        const uint64_t mul = uint64_t{1} << (8 * n);
+        // Apply "limbs = limbs * 256^n + carry".
+        for (uint32_t& limb : limbs) {
+            carry += mul * limb;
+            limb = carry % BASE58_POW5;
+            carry /= BASE58_POW5;
+        }
+        while (carry != 0) {
+            limbs.push_back(carry % BASE58_POW5);
+            carry /= BASE58_POW5;
+        }
+        input = input.subspan(n);
+    }
+    // Expand the limbs into base58 digits, most significant first.
+    std::vector<unsigned char> b58(limbs.size() * 5);
+    auto out = b58.rbegin();
+    for (uint32_t limb : limbs) {
+        for (int i = 0; i < 5; ++i) {
+            *out++ = limb % 58;
+            limb /= 58;
         }
-
-        assert(carry == 0);
-        length = i;
-        input = input.subspan(1);
     }
     // Skip leading zeroes in base58 result.
-    std::vector<unsigned char>::iterator it = b58.begin() + (size - length);
+    std::vector<unsigned char>::iterator it = b58.begin();
     while (it != b58.end() && *it == 0)
         it++;
     // Translate the result into a string.
@@ -124,6 +124,35 @@ uint32_t EncodingConstant(Encoding encoding) {
     return encoding == Encoding::BECH32 ? 1 : 0x2bc830a3;
 }
 
+/** Compute c0*k(x) for every c0 in GF(32), where k(x) = x^6 mod g(x) is the Bech32 generator
+ *  reduction used by PolyMod. For each set bit n in c0, {2^n}k(x) is added. These constants can be
+ *  computed using the following Sage code (continuing the code in PolyMod):
+ *
+ *  for i in [1,2,4,8,16]: # Print out {1,2,4,8,16}*(g(x) mod x^6), packed in hex integers.
+ *      v = 0
+ *      for coef in reversed((F.fetch_int(i)*(G % x**6)).coefficients(sparse=True)):
+ *          v = v*32 + coef.integer_representation()
+ *      print("0x%x" % v)
+ */
+constexpr std::array<uint32_t, 32> GeneratePolyModTable()
+{
+    constexpr std::array<uint32_t, 5> K{
+        0x3b6a57b2, //     k(x) = {29}x^5 + {22}x^4 + {20}x^3 + {21}x^2 + {29}x + {18}
+        0x26508e6d, //  {2}k(x) = {19}x^5 +  {5}x^4 +     x^3 +  {3}x^2 + {19}x + {13}
+        0x1ea119fa, //  {4}k(x) = {15}x^5 + {10}x^4 +  {2}x^3 +  {6}x^2 + {15}x + {26}
+        0x3d4233dd, //  {8}k(x) = {30}x^5 + {20}x^4 +  {4}x^3 + {12}x^2 + {30}x + {29}
+        0x2a1462b3, // {16}k(x) = {21}x^5 +     x^4 +  {8}x^3 + {24}x^2 + {21}x + {19}
+    };
+    std::array<uint32_t, 32> table{};
+    for (uint32_t c0 = 0; c0 < 32; ++c0) {
+        for (int n = 0; n < 5; ++n) {
+            if ((c0 >> n) & 1) table[c0] ^= K[n];
+        }
+    }
+    return table;
+}
+constexpr std::array<uint32_t, 32> POLYMOD_TABLE = GeneratePolyModTable();
+
 /** This function will compute what 6 5-bit values to XOR into the last 6 input values, in order to
  *  make the checksum 0. These 6 values are packed together in a single 30-bit integer. The higher
  *  bits correspond to earlier values. */
@@ -193,24 +222,9 @@ uint32_t PolyMod(const data& v)
         // First, determine the value of c0:
         uint8_t c0 = c >> 25;
 
-        // Then compute c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i:
-        c = ((c & 0x1ffffff) << 5) ^ v_i;
-
-        // Finally, for each set bit n in c0, conditionally add {2^n}k(x). These constants can be
-        // computed using the following Sage code (continuing the code above):
-        //
-        // for i in [1,2,4,8,16]: # Print out {1,2,4,8,16}*(g(x) mod x^6), packed in hex integers.
-        //     v = 0
-        //     for coef in reversed((F.fetch_int(i)*(G % x**6)).coefficients(sparse=True)):
-        //         v = v*32 + coef.integer_representation()
-        //     print("0x%x" % v)
-        //
-        if (c0 & 1)  c ^= 0x3b6a57b2; //     k(x) = {29}x^5 + {22}x^4 + {20}x^3 + {21}x^2 + {29}x + {18}
-        if (c0 & 2)  c ^= 0x26508e6d; //  {2}k(x) = {19}x^5 +  {5}x^4 +     x^3 +  {3}x^2 + {19}x + {13}
-        if (c0 & 4)  c ^= 0x1ea119fa; //  {4}k(x) = {15}x^5 + {10}x^4 +  {2}x^3 +  {6}x^2 + {15}x + {26}
-        if (c0 & 8)  c ^= 0x3d4233dd; //  {8}k(x) = {30}x^5 + {20}x^4 +  {4}x^3 + {12}x^2 + {30}x + {29}
-        if (c0 & 16) c ^= 0x2a1462b3; // {16}k(x) = {21}x^5 +     x^4 +  {8}x^3 + {24}x^2 + {21}x + {19}
-
+        // Then compute c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i, and add c0*k(x) from a
+        // table indexed by c0 (see GeneratePolyModTable):
+        c = ((c & 0x1ffffff) << 5) ^ v_i ^ POLYMOD_TABLE[c0];
     }
     return c;
 }
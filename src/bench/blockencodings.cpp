@@ -0,0 +1,155 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <chainparams.h>
+#include <consensus/amount.h>
+#include <consensus/merkle.h>
+#include <kernel/cs_main.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <streams.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+#include <util/hasher.h>
+#include <util/translation.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+static constexpr size_t NUM_HOPS{6};
+static constexpr size_t NUM_BLOCK_TXS{2000};
+/** One in this many of the block's transactions arrived shortly before it, and each node still has
+ *  them queued for announcement to its neighbour. */
+static constexpr size_t RECENT_ONE_IN{100};
+/** A node misses one in this many of the block's recent transactions... */
+static constexpr size_t MISSING_RECENT_ONE_IN{2};
+/** ...and one in this many of the others from its mempool. */
+static constexpr size_t MISSING_ONE_IN{1000};
+static constexpr size_t MAX_PREDICTED_PREFILL_SIZE{10'000};
+
+static CBlock CreateBlock(FastRandomContext& det_rand)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = det_rand.rand256();
+    block.nBits = 0x207fffff;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.emplace_back();
+    coinbase.vin[0].scriptSig = CScript() << OP_1 << OP_1;
+    coinbase.vout.emplace_back(50 * COIN, CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    for (size_t i = 1; i < NUM_BLOCK_TXS; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+        tx.vin[0].scriptWitness.stack.push_back({1});
+        tx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, Params().GetConsensus())) ++block.nNonce;
+    return block;
+}
+
+/**
+ * Relay a block as compact blocks along a line of nodes, each of which misses a different random
+ * subset of the block's transactions from its mempool, including the GETBLOCKTXN round trips this
+ * requires.
+ *
+ * This measures the processing time of the relay, not its latency: each round trip also adds a
+ * network round trip time at that hop, which dwarfs the processing time but is not simulated. With
+ * prediction, a node prefills the transactions it still has queued for announcement to its
+ * neighbour, as net_processing does: the recent ones it received, which it did not announce yet.
+ * Transactions a node missed itself are never queued, so their round trips remain.
+ */
+static void CmpctBlockRelayMultiHop(benchmark::Bench& bench, bool predict)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::REGTEST);
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    const CBlock block{CreateBlock(det_rand)};
+
+    std::vector<std::unique_ptr<CTxMemPool>> pools;
+    // The transactions each node has queued for announcement to the next one.
+    std::vector<std::unordered_set<Txid, SaltedTxidHasher>> to_send(NUM_HOPS);
+    for (size_t hop = 0; hop < NUM_HOPS; ++hop) {
+        bilingual_str error;
+        pools.push_back(std::make_unique<CTxMemPool>(MemPoolOptionsForTest(testing_setup->m_node), error));
+        TestMemPoolEntryHelper entry;
+        LOCK2(cs_main, pools.back()->cs);
+        for (size_t i = 1; i < block.vtx.size(); ++i) {
+            const bool recent{det_rand.randrange(RECENT_ONE_IN) == 0};
+            // The node that mined the block has all of its transactions.
+            if (hop > 0 && det_rand.randrange(recent ? MISSING_RECENT_ONE_IN : MISSING_ONE_IN) == 0) continue;
+            pools.back()->addUnchecked(entry.FromTx(block.vtx[i]));
+            if (recent) to_send[hop].insert(block.vtx[i]->GetHash());
+        }
+    }
+
+    const std::vector<CTransactionRef> no_extra_txn;
+    bench.run([&] {
+        auto relayed{std::make_shared<const CBlock>(block)};
+        for (size_t hop = 1; hop < NUM_HOPS; ++hop) {
+            CBlockHeaderAndShortTxIDs cmpctblock{*relayed, det_rand.rand64()};
+            if (predict) {
+                std::vector<uint16_t> predicted;
+                size_t prefill_bytes{0};
+                for (size_t i = 1; i < relayed->vtx.size(); ++i) {
+                    const CTransaction& tx{*relayed->vtx[i]};
+                    if (!to_send[hop - 1].contains(tx.GetHash()) || prefill_bytes + tx.GetTotalSize() > MAX_PREDICTED_PREFILL_SIZE) continue;
+                    prefill_bytes += tx.GetTotalSize();
+                    predicted.push_back(i);
+                }
+                if (!predicted.empty()) cmpctblock = CBlockHeaderAndShortTxIDs{cmpctblock, *relayed, predicted};
+            }
+            DataStream stream{};
+            stream << cmpctblock;
+
+            CBlockHeaderAndShortTxIDs received;
+            stream >> received;
+            PartiallyDownloadedBlock partial_block{pools[hop].get()};
+            assert(partial_block.InitData(received, no_extra_txn) == READ_STATUS_OK);
+            BlockTransactionsRequest req;
+            req.blockhash = received.header.GetHash();
+            for (size_t i = 0; i < received.BlockTxCount(); ++i) {
+                if (!partial_block.IsTxAvailable(i)) req.indexes.push_back(i);
+            }
+            BlockTransactions resp;
+            if (!req.indexes.empty()) {
+                stream << req;
+                BlockTransactionsRequest req_received;
+                stream >> req_received;
+                BlockTransactions resp_sent{req_received};
+                for (size_t i = 0; i < req_received.indexes.size(); ++i) {
+                    resp_sent.txn[i] = relayed->vtx[req_received.indexes[i]];
+                }
+                stream << resp_sent;
+                stream >> resp;
+            }
+
+            auto reconstructed{std::make_shared<CBlock>()};
+            assert(partial_block.FillBlock(*reconstructed, resp.txn) == READ_STATUS_OK);
+            relayed = std::move(reconstructed);
+        }
+        assert(relayed->GetHash() == block.GetHash());
+    });
+}
+
+static void CmpctBlockRelayMultiHopCoinbaseOnly(benchmark::Bench& bench) { CmpctBlockRelayMultiHop(bench, /*predict=*/false); }
+static void CmpctBlockRelayMultiHopPredicted(benchmark::Bench& bench) { CmpctBlockRelayMultiHop(bench, /*predict=*/true); }
+
+BENCHMARK(CmpctBlockRelayMultiHopCoinbaseOnly, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CmpctBlockRelayMultiHopPredicted, benchmark::PriorityLevel::HIGH);
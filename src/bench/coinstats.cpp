@@ -0,0 +1,59 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <kernel/coinstats.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <cassert>
+#include <memory>
+
+using kernel::CoinStatsHashType;
+using kernel::ComputeUTXOStats;
+
+static constexpr int NUM_COINS{20'000};
+
+static void ComputeUTXOStatsBench(benchmark::Bench& bench, CoinStatsHashType hash_type)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::REGTEST)};
+    ChainstateManager& chainman{*testing_setup->m_node.chainman};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    {
+        LOCK(::cs_main);
+        CCoinsViewCache& coins_tip{chainstate.CoinsTip()};
+        for (int i = 0; i < NUM_COINS; ++i) {
+            Coin coin{CTxOut{rng.randrange(50 * COIN), CScript() << OP_0 << rng.randbytes(20)}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false};
+            coins_tip.AddCoin(COutPoint{Txid::FromUint256(rng.rand256()), 0}, std::move(coin), /*possible_overwrite=*/false);
+        }
+        chainstate.ForceFlushStateToDisk();
+    }
+    CCoinsViewDB* coins_db{WITH_LOCK(::cs_main, return &chainstate.CoinsDB())};
+
+    bench.batch(NUM_COINS).unit("coin").run([&] {
+        const auto stats{ComputeUTXOStats(hash_type, coins_db, chainman.m_blockman)};
+        assert(stats && stats->coins_count == NUM_COINS);
+    });
+}
+
+static void ComputeUTXOStatsHashSerialized(benchmark::Bench& bench)
+{
+    ComputeUTXOStatsBench(bench, CoinStatsHashType::HASH_SERIALIZED);
+}
+
+static void ComputeUTXOStatsMuHash(benchmark::Bench& bench)
+{
+    ComputeUTXOStatsBench(bench, CoinStatsHashType::MUHASH);
+}
+
+BENCHMARK(ComputeUTXOStatsHashSerialized, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ComputeUTXOStatsMuHash, benchmark::PriorityLevel::HIGH);
@@ -11,6 +11,7 @@
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <hash.h>
 #include <random.h>
 #include <span.h>
 #include <tinyformat.h>
@@ -31,6 +32,24 @@ static void BenchRIPEMD160(benchmark::Bench& bench)
     });
 }
 
+static void RIPEMD160_32_1024(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(32 * 1024, 0);
+    std::vector<uint8_t> out(CRIPEMD160::OUTPUT_SIZE * 1024);
+    bench.batch(in.size()).unit("byte").run([&] {
+        RIPEMD160_32(out.data(), in.data(), 1024);
+    });
+}
+
+static void Hash160Batch_Pubkeys_1024(benchmark::Bench& bench)
+{
+    const std::vector<uint8_t> pubkey(33, 0x02);
+    const std::vector<Span<const uint8_t>> pubkeys(1024, pubkey);
+    bench.batch(pubkeys.size()).unit("pubkey").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(Hash160Batch(pubkeys));
+    });
+}
+
 static void SHA1(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA1::OUTPUT_SIZE];
@@ -171,6 +190,16 @@ static void SHA256D64_1024_AVX2(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+static void SHA256D64_1024_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AVX2_AND_AVX512)));
+    std::vector<uint8_t> in(64 * 1024, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        SHA256D64(in.data(), in.data(), 1024);
+    });
+    SHA256AutoDetect();
+}
+
 static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
 {
     bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
@@ -181,6 +210,67 @@ static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+/** Messages of varied lengths, around the size of a transaction, for the variable-length multi-buffer benchmarks. */
+static std::vector<std::vector<unsigned char>> VarLenMessages()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> msgs(1024);
+    for (auto& msg : msgs) msg = rng.randbytes(100 + rng.randrange(400));
+    return msgs;
+}
+
+/** Hash the VarLenMessages() one at a time, or all together with SHA256Multi. */
+static void SHA256VarLen(benchmark::Bench& bench, bool multi)
+{
+    const auto msgs{VarLenMessages()};
+    std::vector<const unsigned char*> inputs;
+    std::vector<size_t> lengths;
+    uint64_t total{0};
+    for (const auto& msg : msgs) {
+        inputs.push_back(msg.data());
+        lengths.push_back(msg.size());
+        total += msg.size();
+    }
+    std::vector<unsigned char> out(CSHA256::OUTPUT_SIZE * msgs.size());
+    bench.batch(total).unit("byte").run([&] {
+        if (multi) {
+            SHA256Multi(out.data(), inputs.data(), lengths.data(), msgs.size());
+        } else {
+            for (size_t i = 0; i < msgs.size(); ++i) {
+                CSHA256().Write(inputs[i], lengths[i]).Finalize(out.data() + CSHA256::OUTPUT_SIZE * i);
+            }
+        }
+    });
+}
+
+static void SHA256_VarLen_1024_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX2)));
+    SHA256VarLen(bench, /*multi=*/false);
+    SHA256AutoDetect();
+}
+
+static void SHA256Multi_VarLen_1024_AVX2(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX2)));
+    SHA256VarLen(bench, /*multi=*/true);
+    SHA256AutoDetect();
+}
+
+static void SHA256_VarLen_1024_SHANI(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
+    SHA256VarLen(bench, /*multi=*/false);
+    SHA256AutoDetect();
+}
+
+static void SHA256Multi_VarLen_1024_SHANI(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
+    SHA256VarLen(bench, /*multi=*/true);
+    SHA256AutoDetect();
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -244,6 +334,8 @@ static void MuHashPrecompute(benchmark::Bench& bench)
 }
 
 BENCHMARK(BenchRIPEMD160, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RIPEMD160_32_1024, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160Batch_Pubkeys_1024, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA1, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_SSE4, benchmark::PriorityLevel::HIGH);
@@ -260,7 +352,12 @@ BENCHMARK(SipHash_32b, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256D64_1024_AVX512, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256_VarLen_1024_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256Multi_VarLen_1024_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256_VarLen_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256Multi_VarLen_1024_SHANI, benchmark::PriorityLevel::HIGH);
 
 BENCHMARK(MuHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
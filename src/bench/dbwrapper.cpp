@@ -0,0 +1,55 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <random.h>
+#include <uint256.h>
+#include <util/fs.h>
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+static constexpr size_t NUM_KEYS{100'000};
+static constexpr size_t CACHE_BYTES{8 << 20};
+
+//! Coin-like workload: many small random keys written in batches, followed
+//! by point lookups of keys that mostly don't exist (as when checking for
+//! coins that have not been flushed yet).
+static void DBWrapperLookups(benchmark::Bench& bench, const DBOptions& options)
+{
+    CDBWrapper db{{.path = "bench_dbwrapper", .cache_bytes = CACHE_BYTES, .memory_only = true, .options = options}};
+    FastRandomContext rng{/*fDeterministic=*/true};
+
+    CDBBatch batch{db};
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        batch.Write(std::make_pair(uint8_t{'C'}, rng.rand256()), rng.randbytes(40));
+        if (batch.SizeEstimate() > (1 << 20)) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    db.WriteBatch(batch);
+
+    bench.batch(1000).unit("lookup").run([&] {
+        for (int i = 0; i < 1000; ++i) {
+            const bool found{db.Exists(std::make_pair(uint8_t{'C'}, rng.rand256()))};
+            assert(!found);
+        }
+    });
+}
+
+static void DBWrapperLookupsBloomFilter(benchmark::Bench& bench)
+{
+    DBWrapperLookups(bench, DBOptions{});
+}
+
+static void DBWrapperLookupsNoBloomFilter(benchmark::Bench& bench)
+{
+    DBWrapperLookups(bench, DBOptions{.bloom_filter_bits = 0});
+}
+
+BENCHMARK(DBWrapperLookupsBloomFilter, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperLookupsNoBloomFilter, benchmark::PriorityLevel::HIGH);
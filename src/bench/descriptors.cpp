@@ -7,6 +7,7 @@
 #include <script/descriptor.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
+#include <test/util/setup_common.h>
 
 #include <cassert>
 #include <cstdint>
@@ -34,4 +35,48 @@ static void ExpandDescriptor(benchmark::Bench& bench)
     });
 }
 
+/** Number of positions of a ranged descriptor expanded at once, as a wallet keypool top up does. */
+static constexpr int DESCRIPTOR_RANGE_SIZE{1000};
+
+/** Expand a ranged descriptor from its cache as a wallet top up does, either position by position
+ *  or over the whole range, which hashes the key IDs of all positions together. */
+static void ExpandDescriptorRangeFromCache(benchmark::Bench& bench, bool whole_range)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::MAIN)};
+    FlatSigningProvider keys;
+    std::string error;
+    const auto descs{Parse("wpkh(xpub6ERApfZwUNrhLCkDtcHTcxd75RbzS1ed54G1LkBUHQVHQKqhMkhgbmJbZRkrgZw4koxb5JaHWkY4ALHY2grBGRjaDMzQLcgJvLJuZZvRcEL/0/*)", keys, error)};
+    assert(descs.size() == 1);
+    DescriptorCache cache;
+    std::vector<CScript> scripts;
+    FlatSigningProvider out;
+    assert(descs[0]->Expand(0, keys, scripts, out, &cache));
+
+    bench.batch(DESCRIPTOR_RANGE_SIZE).unit("position").run([&] {
+        if (whole_range) {
+            std::vector<std::vector<CScript>> range_scripts;
+            std::vector<FlatSigningProvider> range_out;
+            assert(descs[0]->ExpandRangeFromCache(0, DESCRIPTOR_RANGE_SIZE, cache, range_scripts, range_out));
+        } else {
+            for (int i = 0; i < DESCRIPTOR_RANGE_SIZE; ++i) {
+                std::vector<CScript> pos_scripts;
+                FlatSigningProvider pos_out;
+                assert(descs[0]->ExpandFromCache(i, cache, pos_scripts, pos_out));
+            }
+        }
+    });
+}
+
+static void ExpandDescriptorRange_EachPosition(benchmark::Bench& bench)
+{
+    ExpandDescriptorRangeFromCache(bench, /*whole_range=*/false);
+}
+
+static void ExpandDescriptorRange_WholeRange(benchmark::Bench& bench)
+{
+    ExpandDescriptorRangeFromCache(bench, /*whole_range=*/true);
+}
+
 BENCHMARK(ExpandDescriptor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ExpandDescriptorRange_EachPosition, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ExpandDescriptorRange_WholeRange, benchmark::PriorityLevel::HIGH);
@@ -19,6 +19,8 @@
 
 constexpr size_t BLOCK_VTX_COUNT{4000};
 constexpr size_t BLOCK_VTX_COUNT_10PERCENT{400};
+constexpr size_t DEEP_REORG_DEPTH{10};
+constexpr size_t DEEP_REORG_BLOCK_VTX_COUNT{1000};
 
 using BlockTxns = decltype(CBlock::vtx);
 
@@ -134,6 +136,36 @@ static void AddAndRemoveDisconnectedBlockTransactions10(benchmark::Bench& bench)
     });
 }
 
+/** Disconnect DEEP_REORG_DEPTH blocks, tip first, then connect a competing chain of the same length
+ * which confirms 90% of the disconnected transactions. */
+static void AddAndRemoveDisconnectedBlockTransactionsDeepReorg(benchmark::Bench& bench)
+{
+    std::vector<BlockTxns> disconnected_blocks;
+    std::vector<BlockTxns> connected_blocks;
+    for (size_t i{0}; i < DEEP_REORG_DEPTH; ++i) {
+        const auto num_not_shared{DEEP_REORG_BLOCK_VTX_COUNT / 10};
+        const auto shared_txns{CreateRandomTransactions(/*num_txns=*/DEEP_REORG_BLOCK_VTX_COUNT - num_not_shared)};
+        auto& disconnected{disconnected_blocks.emplace_back(CreateRandomTransactions(/*num_txns=*/num_not_shared))};
+        std::copy(shared_txns.begin(), shared_txns.end(), std::back_inserter(disconnected));
+        auto& connected{connected_blocks.emplace_back(CreateRandomTransactions(/*num_txns=*/num_not_shared))};
+        std::copy(shared_txns.begin(), shared_txns.end(), std::back_inserter(connected));
+    }
+
+    bench.minEpochIterations(10).run([&]() {
+        DisconnectedBlockTransactions disconnectpool{MAX_DISCONNECTED_TX_POOL_BYTES};
+        for (auto it{disconnected_blocks.rbegin()}; it != disconnected_blocks.rend(); ++it) {
+            const auto evicted = disconnectpool.AddTransactionsFromBlock(*it);
+            assert(evicted.empty());
+        }
+        for (const auto& block : connected_blocks) {
+            disconnectpool.removeForBlock(block);
+        }
+        assert(disconnectpool.size() == DEEP_REORG_DEPTH * (DEEP_REORG_BLOCK_VTX_COUNT / 10));
+        disconnectpool.clear();
+    });
+}
+
 BENCHMARK(AddAndRemoveDisconnectedBlockTransactionsAll, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddAndRemoveDisconnectedBlockTransactions90, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddAndRemoveDisconnectedBlockTransactions10, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddAndRemoveDisconnectedBlockTransactionsDeepReorg, benchmark::PriorityLevel::HIGH);
@@ -22,13 +22,14 @@
 #include <vector>
 
 /**
- * The LoadExternalBlockFile() function is used during -reindex and -loadblock.
+ * The LoadExternalBlockFile() function is used during -loadblock. -reindex uses
+ * ChainstateManager::ReindexBlockFiles() instead, so the node no longer passes
+ * blocks_with_unknown_parent; this benchmark still does.
  *
  * Create a test file that's similar to a datadir/blocks/blk?????.dat file,
  * It contains around 134 copies of the same block (typical size of real block files).
  * For each block in the file, LoadExternalBlockFile() won't find its parent,
- * and so will skip the block. (In the real system, it will re-read the block
- * from disk later when it encounters its parent.)
+ * and so will skip the block, remembering its position in blocks_with_unknown_parent.
  *
  * This benchmark measures the performance of deserializing the block (or just
  * its header, beginning with PR 16981).
@@ -0,0 +1,67 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_removal_reason.h>
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+#include <util/fs.h>
+#include <validation.h>
+
+#include <cstddef>
+#include <vector>
+
+static constexpr size_t NUM_TXS{1000};
+
+/**
+ * Reload a mempool.dat of transactions with signatures from the script check threads' point of
+ * view: their scripts have not been verified yet, so neither the signature cache nor the script
+ * execution cache helps. Both are warm after a load, so the file is loaded only once.
+ */
+static void MempoolLoad(benchmark::Bench& bench)
+{
+    auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    CTxMemPool& pool{*Assert(testing_setup->m_node.mempool)};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash(testing_setup->coinbaseKey.GetPubKey()))};
+
+    // Split a mature coinbase into one output for each transaction to load.
+    const CTransactionRef coinbase{testing_setup->m_coinbase_txns[0]};
+    const std::vector<CTxOut> outputs(NUM_TXS, CTxOut{(coinbase->vout[0].nValue - COIN) / static_cast<CAmount>(NUM_TXS), spk});
+    const auto fanout{testing_setup->CreateValidMempoolTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}},
+                                                                    /*input_height=*/1, {testing_setup->coinbaseKey}, outputs, /*submit=*/false)};
+    testing_setup->CreateAndProcessBlock({fanout}, spk);
+    const CTransactionRef fanout_tx{MakeTransactionRef(fanout)};
+    const int fanout_height{WITH_LOCK(::cs_main, return chainstate.m_chain.Height())};
+
+    // Add the transactions without validating them, which would warm the caches.
+    std::vector<CTransactionRef> txs;
+    TestMemPoolEntryHelper entry;
+    for (uint32_t n{0}; n < NUM_TXS; ++n) {
+        txs.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(fanout_tx, n, fanout_height, testing_setup->coinbaseKey,
+                                                                                      spk, outputs[n].nValue - 1000, /*submit=*/false)));
+        LOCK2(::cs_main, pool.cs);
+        pool.addUnchecked(entry.Fee(1000).FromTx(txs.back()));
+    }
+    assert(pool.size() == NUM_TXS);
+    const fs::path mempool_dat{testing_setup->m_path_root / "mempool.dat"};
+    assert(node::DumpMempool(pool, mempool_dat));
+
+    bench.epochs(1).epochIterations(1).run([&] {
+        WITH_LOCK(pool.cs, for (const auto& tx : txs) pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED));
+        assert(node::LoadMempool(pool, mempool_dat, chainstate, {.use_current_time = true}));
+        assert(pool.size() == NUM_TXS);
+    });
+    fs::remove(mempool_dat);
+}
+
+BENCHMARK(MempoolLoad, benchmark::PriorityLevel::HIGH);
@@ -10,14 +10,21 @@
 #include <script/script.h>
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <tinyformat.h>
 #include <txmempool.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 #include <memory>
 #include <vector>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 class CCoinsViewCache;
 
 static void AddTx(const CTransactionRef& tx, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
@@ -110,6 +117,46 @@ static void ComplexMemPool(benchmark::Bench& bench)
     });
 }
 
+/** Resident set size of the process in bytes, or 0 where it cannot be read. */
+static size_t ResidentMemory()
+{
+#ifdef __linux__
+    std::ifstream statm{"/proc/self/statm"};
+    size_t size{0}, resident{0};
+    if (statm >> size >> resident) return resident * sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
+
+static void MempoolMemoryChurn(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+
+    // Fill the mempool once, to compare the memory it reports with how much the process grew while
+    // creating and adding the transactions.
+    const size_t rss_before{ResidentMemory()};
+    FastRandomContext det_rand{true};
+    const std::vector<CTransactionRef> ordered_coins{CreateOrderedCoins(det_rand, /*childTxs=*/10000, /*min_ancestors=*/1)};
+    LOCK2(cs_main, pool.cs);
+    for (auto& tx : ordered_coins) {
+        AddTx(tx, pool);
+    }
+    const size_t usage_full{pool.DynamicMemoryUsage()};
+    const size_t rss_full{ResidentMemory()};
+    bench.name(strprintf("%s (%u txs: DynamicMemoryUsage %.1f MiB, RSS growth %.1f MiB)", __func__, ordered_coins.size(),
+                         usage_full / 1048576.0, (rss_full - std::min(rss_before, rss_full)) / 1048576.0));
+
+    // Evict half of the mempool and add the evicted transactions back, which reuses the memory they
+    // gave back to the pool.
+    bench.run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        pool.TrimToSize(usage_full / 2);
+        for (auto& tx : ordered_coins) {
+            if (!pool.exists(GenTxid::Txid(tx->GetHash()))) AddTx(tx, pool);
+        }
+    });
+}
+
 static void MempoolCheck(benchmark::Bench& bench)
 {
     FastRandomContext det_rand{true};
@@ -127,3 +174,4 @@ static void MempoolCheck(benchmark::Bench& bench)
 
 BENCHMARK(ComplexMemPool, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MempoolCheck, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolMemoryChurn, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,79 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <chain.h>
+#include <consensus/amount.h>
+#include <consensus/validation.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static constexpr int REORG_DEPTH{10};
+static constexpr size_t REORG_BLOCK_TXS{100};
+
+/**
+ * Reorg away from REORG_DEPTH blocks of transactions to a longer chain of empty blocks, which
+ * disconnects them in one ActivateBestChainStep, their block and undo data read ahead of
+ * DisconnectTip. Each iteration reorgs back by invalidating the empty chain, so it also includes
+ * connecting the blocks again.
+ */
+static void DisconnectTipDeepReorg(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    ChainstateManager& chainman{*testing_setup->m_node.chainman};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash(testing_setup->coinbaseKey.GetPubKey()))};
+
+    // The chain reorged to, invalidated while the one it replaces is built.
+    uint256 other_first_hash;
+    for (int i = 0; i <= REORG_DEPTH; ++i) {
+        const CBlock block{testing_setup->CreateAndProcessBlock({}, CScript() << OP_TRUE)};
+        if (i == 0) other_first_hash = block.GetHash();
+    }
+    const uint256 other_tip{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    CBlockIndex* other_first{WITH_LOCK(::cs_main, return chainman.m_blockman.LookupBlockIndex(other_first_hash))};
+    BlockValidationState state;
+    assert(chainstate.InvalidateBlock(state, other_first));
+
+    // Each block splits a mature coinbase into REORG_BLOCK_TXS outputs, which the transactions of
+    // the next block spend.
+    CTransactionRef fanout_tx;
+    for (int i = 0; i < REORG_DEPTH; ++i) {
+        const int height{WITH_LOCK(::cs_main, return chainstate.m_chain.Height()) + 1};
+        std::vector<CMutableTransaction> txs;
+        for (uint32_t n{0}; fanout_tx && n < REORG_BLOCK_TXS; ++n) {
+            txs.push_back(testing_setup->CreateValidMempoolTransaction(fanout_tx, n, height - 1, testing_setup->coinbaseKey,
+                                                                       spk, fanout_tx->vout[n].nValue - 1000, /*submit=*/false));
+        }
+        const CTransactionRef coinbase{testing_setup->m_coinbase_txns[i]};
+        const std::vector<CTxOut> outputs(REORG_BLOCK_TXS, CTxOut{(coinbase->vout[0].nValue - COIN) / static_cast<CAmount>(REORG_BLOCK_TXS), spk});
+        txs.push_back(testing_setup->CreateValidMempoolTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}},
+                                                                   /*input_height=*/i + 1, {testing_setup->coinbaseKey}, outputs, /*submit=*/false));
+        fanout_tx = MakeTransactionRef(txs.back());
+        testing_setup->CreateAndProcessBlock(txs, spk);
+    }
+    const uint256 tip{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+
+    bench.batch(REORG_DEPTH).unit("block").run([&] {
+        WITH_LOCK(::cs_main, chainstate.ResetBlockFailureFlags(other_first));
+        assert(chainstate.ActivateBestChain(state));
+        assert(WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash()) == other_tip);
+        assert(chainstate.InvalidateBlock(state, other_first));
+        assert(chainstate.ActivateBestChain(state));
+        assert(WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash()) == tip);
+    });
+}
+
+BENCHMARK(DisconnectTipDeepReorg, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,73 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+//! Number of headers in a full headers message.
+static constexpr size_t HEADERS_COUNT{2000};
+
+static std::vector<CBlockHeader> CreateHeaders()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CBlockHeader> headers(HEADERS_COUNT);
+    for (auto& header : headers) {
+        header.nVersion = rng.rand32();
+        header.hashPrevBlock = rng.rand256();
+        header.hashMerkleRoot = rng.rand256();
+        header.nTime = rng.rand32();
+        header.nBits = rng.rand32();
+        header.nNonce = rng.rand32();
+    }
+    return headers;
+}
+
+static void SerializeBlockHeaders(benchmark::Bench& bench)
+{
+    const auto headers{CreateHeaders()};
+    DataStream stream;
+    bench.batch(headers.size()).unit("header").run([&] {
+        stream.clear();
+        stream << headers;
+        assert(stream.size() == GetSerializeSize(headers));
+    });
+}
+
+static void DeserializeBlockHeaders(benchmark::Bench& bench)
+{
+    DataStream stream;
+    stream << CreateHeaders();
+    std::vector<CBlockHeader> headers;
+    bench.batch(HEADERS_COUNT).unit("header").run([&] {
+        SpanReader{MakeUCharSpan(stream)} >> headers;
+        assert(headers.size() == HEADERS_COUNT);
+    });
+}
+
+static void HashOutPoints(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    for (size_t i{0}; i < 1000; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), rng.rand32());
+    }
+    bench.batch(outpoints.size()).unit("outpoint").run([&] {
+        HashWriter hasher{};
+        for (const auto& outpoint : outpoints) hasher << outpoint;
+        ankerl::nanobench::doNotOptimizeAway(hasher.GetHash());
+    });
+}
+
+BENCHMARK(SerializeBlockHeaders, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockHeaders, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HashOutPoints, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,83 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <net.h>
+#include <net_processing.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <txorphanage.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static constexpr NodeId HONEST_PEER{0};
+static constexpr size_t NUM_HONEST_ORPHANS{4};
+static constexpr NodeId NUM_ATTACKERS{20};
+static constexpr size_t ORPHANS_PER_ATTACKER{500};
+
+/** Transactions spending random outpoints, or the given ones, one input each. */
+static std::vector<CTransactionRef> CreateOrphans(FastRandomContext& det_rand, size_t count, const std::vector<COutPoint>& prevouts = {})
+{
+    std::vector<CTransactionRef> orphans;
+    orphans.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(prevouts.empty() ? COutPoint{Txid::FromUint256(det_rand.rand256()), 0} : prevouts[i]);
+        tx.vin[0].scriptWitness.stack.push_back({1});
+        tx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        orphans.push_back(MakeTransactionRef(tx));
+    }
+    return orphans;
+}
+
+/** Attackers keep the orphanage full while an honest peer's orphans, within its share of the
+ *  limit, wait for their parents. */
+static void OrphanageAdversarialPeers(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    const auto honest_orphans{CreateOrphans(det_rand, NUM_HONEST_ORPHANS)};
+    const auto attacker_orphans{CreateOrphans(det_rand, NUM_ATTACKERS * ORPHANS_PER_ATTACKER)};
+
+    bench.run([&] {
+        TxOrphanage orphanage;
+        for (const auto& tx : honest_orphans) orphanage.AddTx(tx, HONEST_PEER);
+        for (size_t i = 0; i < attacker_orphans.size(); ++i) {
+            orphanage.AddTx(attacker_orphans[i], /*peer=*/1 + i % NUM_ATTACKERS);
+            orphanage.LimitOrphans(DEFAULT_MAX_ORPHAN_TRANSACTIONS);
+        }
+        for (const auto& tx : honest_orphans) assert(orphanage.HaveTx(tx->GetWitnessHash()));
+        for (NodeId peer = 1; peer <= NUM_ATTACKERS; ++peer) orphanage.EraseForPeer(peer);
+        assert(orphanage.Size() == NUM_HONEST_ORPHANS);
+    });
+}
+
+/** A block confirming transactions which conflict with half of a full orphanage. */
+static void OrphanageEraseForBlock(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    const auto orphans{CreateOrphans(det_rand, DEFAULT_MAX_ORPHAN_TRANSACTIONS)};
+
+    std::vector<COutPoint> block_prevouts;
+    for (size_t i = 0; i < 2000; ++i) {
+        block_prevouts.push_back(i % 40 == 0 ? orphans[i / 40]->vin[0].prevout : COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+    }
+    CBlock block;
+    block.vtx = CreateOrphans(det_rand, block_prevouts.size(), block_prevouts);
+
+    bench.run([&] {
+        TxOrphanage orphanage;
+        for (size_t i = 0; i < orphans.size(); ++i) orphanage.AddTx(orphans[i], /*peer=*/i % 8);
+        orphanage.EraseForBlock(block);
+        assert(orphanage.Size() == orphans.size() / 2);
+    });
+}
+
+BENCHMARK(OrphanageAdversarialPeers, benchmark::PriorityLevel::HIGH);
+BENCHMARK(OrphanageEraseForBlock, benchmark::PriorityLevel::HIGH);
@@ -9,6 +9,7 @@
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
+#include <script/signingprovider.h>
 #include <span.h>
 #include <test/util/transaction_utils.h>
 #include <uint256.h>
@@ -66,6 +67,112 @@ static void VerifyScriptBench(benchmark::Bench& bench)
     });
 }
 
+static CKey DeterministicKey(unsigned char n)
+{
+    std::array<unsigned char, 32> key_data{};
+    key_data.back() = n;
+    CKey key;
+    key.Set(key_data.begin(), key_data.end(), /*fCompressedIn=*/true);
+    return key;
+}
+
+// Microbenchmark for verification of a 2-of-3 P2WSH multisig script.
+static void VerifyP2WSHMultisigBench(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    const uint32_t flags{SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_P2SH};
+    const std::array<CKey, 3> keys{DeterministicKey(1), DeterministicKey(2), DeterministicKey(3)};
+
+    CScript witness_script = CScript() << OP_2;
+    for (const CKey& key : keys) witness_script << ToByteVector(key.GetPubKey());
+    witness_script << OP_3 << OP_CHECKMULTISIG;
+    const CScript script_pubkey = CScript() << OP_0 << ToByteVector(WitnessV0ScriptHash{witness_script});
+
+    const CMutableTransaction tx_credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction tx_spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(tx_credit))};
+    const uint256 sighash{SignatureHash(witness_script, tx_spend, 0, SIGHASH_ALL, tx_credit.vout[0].nValue, SigVersion::WITNESS_V0)};
+    CScriptWitness& witness = tx_spend.vin[0].scriptWitness;
+    witness.stack.emplace_back(); // CHECKMULTISIG dummy element
+    for (const CKey& key : {keys[0], keys[2]}) {
+        auto& sig{witness.stack.emplace_back()};
+        key.Sign(sighash, sig);
+        sig.push_back(static_cast<unsigned char>(SIGHASH_ALL));
+    }
+    witness.stack.emplace_back(witness_script.begin(), witness_script.end());
+
+    bench.run([&] {
+        ScriptError err;
+        bool success = VerifyScript(
+            tx_spend.vin[0].scriptSig,
+            tx_credit.vout[0].scriptPubKey,
+            &tx_spend.vin[0].scriptWitness,
+            flags,
+            MutableTransactionSignatureChecker(&tx_spend, 0, tx_credit.vout[0].nValue, MissingDataBehavior::ASSERT_FAIL),
+            &err);
+        assert(err == SCRIPT_ERR_OK);
+        assert(success);
+    });
+}
+
+// Microbenchmark for verification of a taproot script path spend whose
+// tapscript duplicates and drops a large witness element many times before
+// checking a signature, to measure stack manipulation overhead.
+static void VerifyTapscriptBench(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    const uint32_t flags{SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_TAPROOT};
+    const CKey key{DeterministicKey(1)};
+    const XOnlyPubKey xonly_pubkey{key.GetPubKey()};
+
+    CScript tapscript;
+    for (int i = 0; i < 100; ++i) {
+        tapscript << OP_DUP << OP_DROP;
+    }
+    tapscript << OP_DROP << ToByteVector(xonly_pubkey) << OP_CHECKSIG;
+
+    TaprootBuilder builder;
+    builder.Add(/*depth=*/0, tapscript, TAPROOT_LEAF_TAPSCRIPT).Finalize(xonly_pubkey);
+    const CScript script_pubkey = CScript() << OP_1 << ToByteVector(builder.GetOutput());
+    const auto control_block{*builder.GetSpendData().scripts.at({{tapscript.begin(), tapscript.end()}, TAPROOT_LEAF_TAPSCRIPT}).begin()};
+
+    const CMutableTransaction tx_credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction tx_spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(tx_credit))};
+    PrecomputedTransactionData txdata;
+    txdata.Init(tx_spend, {tx_credit.vout[0]}, /*force=*/true);
+
+    ScriptExecutionData execdata;
+    execdata.m_annex_init = true;
+    execdata.m_annex_present = false;
+    execdata.m_tapleaf_hash_init = true;
+    execdata.m_tapleaf_hash = ComputeTapleafHash(TAPROOT_LEAF_TAPSCRIPT, tapscript);
+    execdata.m_codeseparator_pos_init = true;
+    execdata.m_codeseparator_pos = 0xFFFFFFFF;
+    uint256 sighash;
+    assert(SignatureHashSchnorr(sighash, execdata, tx_spend, 0, SIGHASH_DEFAULT, SigVersion::TAPSCRIPT, txdata, MissingDataBehavior::ASSERT_FAIL));
+
+    CScriptWitness& witness = tx_spend.vin[0].scriptWitness;
+    auto& sig{witness.stack.emplace_back(64)};
+    assert(key.SignSchnorr(sighash, sig, /*merkle_root=*/nullptr, /*aux=*/uint256{}));
+    witness.stack.emplace_back(MAX_SCRIPT_ELEMENT_SIZE, 0x01);
+    witness.stack.emplace_back(tapscript.begin(), tapscript.end());
+    witness.stack.push_back(control_block);
+
+    bench.run([&] {
+        ScriptError err;
+        bool success = VerifyScript(
+            tx_spend.vin[0].scriptSig,
+            tx_credit.vout[0].scriptPubKey,
+            &tx_spend.vin[0].scriptWitness,
+            flags,
+            MutableTransactionSignatureChecker(&tx_spend, 0, tx_credit.vout[0].nValue, txdata, MissingDataBehavior::ASSERT_FAIL),
+            &err);
+        assert(err == SCRIPT_ERR_OK);
+        assert(success);
+    });
+}
+
 static void VerifyNestedIfScript(benchmark::Bench& bench)
 {
     std::vector<std::vector<unsigned char>> stack;
@@ -88,4 +195,6 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
 }
 
 BENCHMARK(VerifyScriptBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyP2WSHMultisigBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyTapscriptBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(VerifyNestedIfScript, benchmark::PriorityLevel::HIGH);
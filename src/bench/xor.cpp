@@ -21,4 +21,17 @@ static void Xor(benchmark::Bench& bench)
     });
 }
 
+static void XorObfuscationKey(benchmark::Bench& bench)
+{
+    // Same key size as used for the block files and the chainstate
+    FastRandomContext frc{/*fDeterministic=*/true};
+    auto data{frc.randbytes<std::byte>(1 << 20)};
+    auto key{frc.randbytes<std::byte>(8)};
+
+    bench.batch(data.size()).unit("byte").run([&] {
+        util::Xor(data, key, /*key_offset=*/3);
+    });
+}
+
 BENCHMARK(Xor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(XorObfuscationKey, benchmark::PriorityLevel::HIGH);
@@ -43,25 +43,24 @@ void BIP324Cipher::Initialize(const EllSwiftPubKey& their_pubkey, bool initiator
     // Derive encryption keys from shared secret, and initialize stream ciphers and AEADs.
     bool side = (initiator != self_decrypt);
     CHKDF_HMAC_SHA256_L32 hkdf(UCharCast(ecdh_secret.data()), ecdh_secret.size(), salt);
-    std::array<std::byte, 32> hkdf_32_okm;
-    hkdf.Expand32("initiator_L", UCharCast(hkdf_32_okm.data()));
-    (side ? m_send_l_cipher : m_recv_l_cipher).emplace(hkdf_32_okm, REKEY_INTERVAL);
-    hkdf.Expand32("initiator_P", UCharCast(hkdf_32_okm.data()));
-    (side ? m_send_p_cipher : m_recv_p_cipher).emplace(hkdf_32_okm, REKEY_INTERVAL);
-    hkdf.Expand32("responder_L", UCharCast(hkdf_32_okm.data()));
-    (side ? m_recv_l_cipher : m_send_l_cipher).emplace(hkdf_32_okm, REKEY_INTERVAL);
-    hkdf.Expand32("responder_P", UCharCast(hkdf_32_okm.data()));
-    (side ? m_recv_p_cipher : m_send_p_cipher).emplace(hkdf_32_okm, REKEY_INTERVAL);
+    // All keys are derived from the same pseudorandom key, so their HMACs are computed together.
+    std::array<std::byte, 6 * 32> hkdf_32_okm;
+    hkdf.Expand32({"initiator_L", "initiator_P", "responder_L", "responder_P", "garbage_terminators", "session_id"},
+                  UCharCast(hkdf_32_okm.data()));
+    const auto okm{[&](size_t i) { return Span{hkdf_32_okm}.subspan(32 * i, 32); }};
+    (side ? m_send_l_cipher : m_recv_l_cipher).emplace(okm(0), REKEY_INTERVAL);
+    (side ? m_send_p_cipher : m_recv_p_cipher).emplace(okm(1), REKEY_INTERVAL);
+    (side ? m_recv_l_cipher : m_send_l_cipher).emplace(okm(2), REKEY_INTERVAL);
+    (side ? m_recv_p_cipher : m_send_p_cipher).emplace(okm(3), REKEY_INTERVAL);
 
     // Derive garbage terminators from shared secret.
-    hkdf.Expand32("garbage_terminators", UCharCast(hkdf_32_okm.data()));
-    std::copy(std::begin(hkdf_32_okm), std::begin(hkdf_32_okm) + GARBAGE_TERMINATOR_LEN,
+    std::copy(okm(4).begin(), okm(4).begin() + GARBAGE_TERMINATOR_LEN,
         (initiator ? m_send_garbage_terminator : m_recv_garbage_terminator).begin());
-    std::copy(std::end(hkdf_32_okm) - GARBAGE_TERMINATOR_LEN, std::end(hkdf_32_okm),
+    std::copy(okm(4).end() - GARBAGE_TERMINATOR_LEN, okm(4).end(),
         (initiator ? m_recv_garbage_terminator : m_send_garbage_terminator).begin());
 
     // Derive session id from shared secret.
-    hkdf.Expand32("session_id", UCharCast(m_session_id.data()));
+    std::copy(okm(5).begin(), okm(5).end(), m_session_id.begin());
 
     // Wipe all variables that contain information which could be used to re-derive encryption keys.
     memory_cleanse(ecdh_secret.data(), ecdh_secret.size());
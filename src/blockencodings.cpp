@@ -13,6 +13,7 @@
 #include <random.h>
 #include <streams.h>
 #include <txmempool.h>
+#include <util/check.h>
 #include <validation.h>
 
 #include <unordered_map>
@@ -21,7 +22,6 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const
         nonce(nonce),
         shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
     FillShortTxIDSelector();
-    //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
     prefilledtxn[0] = {0, block.vtx[0]};
     for (size_t i = 1; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
@@ -29,6 +29,26 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const
     }
 }
 
+CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlockHeaderAndShortTxIDs& cmpctblock, const CBlock& block,
+                                                     const std::vector<uint16_t>& prefill_indexes) :
+        nonce(cmpctblock.nonce), header(cmpctblock.header) {
+    // The short IDs of cmpctblock are those of all transactions after the coinbase, in block order.
+    Assume(cmpctblock.prefilledtxn.size() == 1 && cmpctblock.shorttxids.size() + 1 == block.vtx.size());
+    FillShortTxIDSelector();
+    shorttxids.reserve(cmpctblock.shorttxids.size() - prefill_indexes.size());
+    prefilledtxn.reserve(1 + prefill_indexes.size());
+    prefilledtxn.push_back(cmpctblock.prefilledtxn[0]);
+    // Prefilled transaction indexes are encoded as offsets from the previous prefilled one.
+    size_t last_prefilled{0};
+    for (const uint16_t index : prefill_indexes) {
+        Assume(index > last_prefilled && index < block.vtx.size());
+        shorttxids.insert(shorttxids.end(), cmpctblock.shorttxids.begin() + last_prefilled, cmpctblock.shorttxids.begin() + index - 1);
+        prefilledtxn.push_back({uint16_t(index - last_prefilled - 1), block.vtx[index]});
+        last_prefilled = index;
+    }
+    shorttxids.insert(shorttxids.end(), cmpctblock.shorttxids.begin() + last_prefilled, cmpctblock.shorttxids.end());
+}
+
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
     DataStream stream{};
     stream << header << nonce;
@@ -116,6 +116,17 @@ public:
      */
     CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce);
 
+    /**
+     * Copy a compact block that prefills only the coinbase, additionally prefilling the given
+     * transactions for a receiver predicted to be missing them. The nonce, and so the short IDs of
+     * the other transactions, are kept.
+     *
+     * @param[in]  cmpctblock       Compact block built from block
+     * @param[in]  prefill_indexes  Increasing indexes in block of the transactions to prefill, after the coinbase
+     */
+    CBlockHeaderAndShortTxIDs(const CBlockHeaderAndShortTxIDs& cmpctblock, const CBlock& block,
+                              const std::vector<uint16_t>& prefill_indexes);
+
     uint64_t GetShortID(const Wtxid& wtxid) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
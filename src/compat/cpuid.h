@@ -22,5 +22,36 @@ void static inline GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32
 #endif
 }
 
+/** Check whether the CPU supports AVX and the OS has enabled the AVX registers. */
+bool static inline AVXEnabled()
+{
+    uint32_t a, b, c, d;
+    GetCPUID(1, 0, a, b, c, d);
+    // XGETBV is only available with XSAVE.
+    const bool have_xsave = (c >> 27) & 1;
+    const bool have_avx = (c >> 28) & 1;
+    if (!have_xsave || !have_avx) return false;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+
+/** Check whether the OS has enabled AVX-512 registers (opmask and both halves of ZMM0-31). Only
+ *  call this if AVXEnabled(). */
+bool static inline AVX512Enabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
+
+/** Check whether the CPU supports AVX2 and the OS has enabled the AVX registers. */
+bool static inline AVX2Enabled()
+{
+    if (!AVXEnabled()) return false;
+    uint32_t a, b, c, d;
+    GetCPUID(7, 0, a, b, c, d);
+    return (b >> 5) & 1;
+}
+
 #endif // defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #endif // BITCOIN_COMPAT_CPUID_H
@@ -8,6 +8,10 @@
 #include <cstring>
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 using ByteAsHex = std::array<char, 2>;
@@ -24,6 +28,29 @@ constexpr std::array<ByteAsHex, 256> CreateByteToHexMap()
     return byte_to_hex;
 }
 
+#if defined(__SSE2__)
+/** Hex encode 16 bytes into 32 characters at once. SSE2 is part of the x86-64 baseline, so no
+ *  runtime detection is needed. */
+void HexEncode16(const uint8_t* in, char* out)
+{
+    const __m128i mask{_mm_set1_epi8(0x0f)};
+    const __m128i nine{_mm_set1_epi8(9)};
+    const __m128i zero_char{_mm_set1_epi8('0')};
+    const __m128i letter_offset{_mm_set1_epi8('a' - '0' - 10)};
+
+    const __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))};
+    const __m128i hi{_mm_and_si128(_mm_srli_epi16(v, 4), mask)};
+    const __m128i lo{_mm_and_si128(v, mask)};
+    for (int half = 0; half < 2; ++half) {
+        // Interleave high and low nibbles, then map 0..9 to '0'..'9' and 10..15 to 'a'..'f'.
+        const __m128i nibbles{half == 0 ? _mm_unpacklo_epi8(hi, lo) : _mm_unpackhi_epi8(hi, lo)};
+        const __m128i letters{_mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter_offset)};
+        const __m128i chars{_mm_add_epi8(_mm_add_epi8(nibbles, zero_char), letters)};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * half), chars);
+    }
+}
+#endif
+
 } // namespace
 
 std::string HexStr(const Span<const uint8_t> s)
@@ -33,7 +60,14 @@ std::string HexStr(const Span<const uint8_t> s)
     static_assert(sizeof(byte_to_hex) == 512);
 
     char* it = rv.data();
-    for (uint8_t v : s) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= s.size(); i += 16) {
+        HexEncode16(s.data() + i, it);
+        it += 32;
+    }
+#endif
+    for (uint8_t v : s.subspan(i)) {
         std::memcpy(it, byte_to_hex[v].data(), 2);
         it += 2;
     }
@@ -60,8 +94,3 @@ const signed char p_util_hexdigit[256] =
   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
   -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, };
 
-signed char HexDigit(char c)
-{
-    return p_util_hexdigit[(unsigned char)c];
-}
-
@@ -18,6 +18,12 @@ std::string HexStr(const Span<const uint8_t> s);
 inline std::string HexStr(const Span<const char> s) { return HexStr(MakeUCharSpan(s)); }
 inline std::string HexStr(const Span<const std::byte> s) { return HexStr(MakeUCharSpan(s)); }
 
-signed char HexDigit(char c);
+/** Value of each hex digit character, or -1 for non-hex characters. */
+extern const signed char p_util_hexdigit[256];
+
+inline signed char HexDigit(char c)
+{
+    return p_util_hexdigit[(unsigned char)c];
+}
 
 #endif // BITCOIN_CRYPTO_HEX_BASE_H
@@ -4,7 +4,11 @@
 
 #include <crypto/hkdf_sha256_32.h>
 
+#include <crypto/sha256.h>
+#include <support/cleanse.h>
+
 #include <assert.h>
+#include <numeric>
 #include <string.h>
 
 CHKDF_HMAC_SHA256_L32::CHKDF_HMAC_SHA256_L32(const unsigned char* ikm, size_t ikmlen, const std::string& salt)
@@ -19,3 +23,52 @@ void CHKDF_HMAC_SHA256_L32::Expand32(const std::string& info, unsigned char hash
     static const unsigned char one[1] = {1};
     CHMAC_SHA256(m_prk, 32).Write((const unsigned char*)info.data(), info.size()).Write(one, 1).Finalize(hash);
 }
+
+void CHKDF_HMAC_SHA256_L32::Expand32(const std::vector<std::string>& infos, unsigned char* hashes)
+{
+    // Each expansion is HMAC(prk, info || 1), as above, but the inner and then the outer hashes of
+    // all of them are computed together.
+    const size_t count{infos.size()};
+    unsigned char ikey[64], okey[64];
+    for (size_t n = 0; n < 64; ++n) {
+        const unsigned char key{n < sizeof(m_prk) ? m_prk[n] : (unsigned char)0};
+        ikey[n] = key ^ 0x36;
+        okey[n] = key ^ 0x5c;
+    }
+
+    // Reserved up front, so no copy of the keys is left behind by a reallocation.
+    std::vector<size_t> inner_lengths;
+    for (const std::string& info : infos) {
+        assert(info.size() <= 128);
+        inner_lengths.push_back(64 + info.size() + 1);
+    }
+    std::vector<unsigned char> inner;
+    inner.reserve(std::accumulate(inner_lengths.begin(), inner_lengths.end(), size_t{0}));
+    for (const std::string& info : infos) {
+        inner.insert(inner.end(), ikey, ikey + 64);
+        inner.insert(inner.end(), info.begin(), info.end());
+        inner.push_back(1);
+    }
+    std::vector<const unsigned char*> inner_data;
+    for (size_t i = 0, offset = 0; i < count; offset += inner_lengths[i++]) {
+        inner_data.push_back(inner.data() + offset);
+    }
+    std::vector<unsigned char> outer(count * 96);
+    std::vector<unsigned char> inner_hashes(count * OUTPUT_SIZE);
+    SHA256Multi(inner_hashes.data(), inner_data.data(), inner_lengths.data(), count);
+
+    std::vector<const unsigned char*> outer_data;
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(outer.data() + 96 * i, okey, 64);
+        memcpy(outer.data() + 96 * i + 64, inner_hashes.data() + OUTPUT_SIZE * i, OUTPUT_SIZE);
+        outer_data.push_back(outer.data() + 96 * i);
+    }
+    const std::vector<size_t> outer_lengths(count, 96);
+    SHA256Multi(hashes, outer_data.data(), outer_lengths.data(), count);
+
+    memory_cleanse(ikey, sizeof(ikey));
+    memory_cleanse(okey, sizeof(okey));
+    memory_cleanse(inner.data(), inner.size());
+    memory_cleanse(outer.data(), outer.size());
+    memory_cleanse(inner_hashes.data(), inner_hashes.size());
+}
@@ -9,6 +9,8 @@
 
 #include <cstdlib>
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 /** A rfc5869 HKDF implementation with HMAC_SHA256 and fixed key output length of 32 bytes (L=32) */
 class CHKDF_HMAC_SHA256_L32
@@ -20,6 +22,9 @@ private:
 public:
     CHKDF_HMAC_SHA256_L32(const unsigned char* ikm, size_t ikmlen, const std::string& salt);
     void Expand32(const std::string& info, unsigned char hash[OUTPUT_SIZE]);
+    /** Expand a key for each of several infos, hashing them together.
+     *  hashes: pointer to an infos.size()*32 byte output buffer */
+    void Expand32(const std::vector<std::string>& infos, unsigned char* hashes);
 };
 
 #endif // BITCOIN_CRYPTO_HKDF_SHA256_32_H
@@ -2,12 +2,23 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+
 #include <crypto/ripemd160.h>
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 
+#include <cassert>
 #include <string.h>
 
+#if defined(ENABLE_AVX2)
+namespace ripemd160_avx2
+{
+void Transform_8way_32(unsigned char* out, const unsigned char* in);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -235,6 +246,37 @@ void Transform(uint32_t* s, const unsigned char* chunk)
 
 } // namespace ripemd160
 
+typedef void (*Transform32Type)(unsigned char*, const unsigned char*);
+
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+/** Check an 8-way transform for 32-byte messages against the generic implementation. */
+bool SelfTest32_8way(Transform32Type transform_8way)
+{
+    unsigned char in[8 * 32];
+    for (size_t i = 0; i < sizeof(in); ++i) in[i] = static_cast<unsigned char>(i * 0x9d + 0x35);
+
+    unsigned char expected[8 * CRIPEMD160::OUTPUT_SIZE];
+    for (size_t i = 0; i < 8; ++i) {
+        CRIPEMD160().Write(in + i * 32, 32).Finalize(expected + i * CRIPEMD160::OUTPUT_SIZE);
+    }
+    unsigned char out[8 * CRIPEMD160::OUTPUT_SIZE];
+    transform_8way(out, in);
+    return memcmp(out, expected, sizeof(out)) == 0;
+}
+#endif
+
+/** Return the 8-way transform for 32-byte messages if the CPU and OS support it. */
+Transform32Type DetectTransform32_8way()
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    if (AVX2Enabled()) {
+        assert(SelfTest32_8way(ripemd160_avx2::Transform_8way_32));
+        return ripemd160_avx2::Transform_8way_32;
+    }
+#endif
+    return nullptr;
+}
+
 } // namespace
 
 ////// RIPEMD160
@@ -290,3 +332,22 @@ CRIPEMD160& CRIPEMD160::Reset()
     ripemd160::Initialize(s);
     return *this;
 }
+
+void RIPEMD160_32(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    static const Transform32Type transform_8way{DetectTransform32_8way()};
+    if (transform_8way) {
+        while (blocks >= 8) {
+            transform_8way(out, in);
+            out += 8 * CRIPEMD160::OUTPUT_SIZE;
+            in += 8 * 32;
+            blocks -= 8;
+        }
+    }
+    while (blocks) {
+        CRIPEMD160().Write(in, 32).Finalize(out);
+        out += CRIPEMD160::OUTPUT_SIZE;
+        in += 32;
+        --blocks;
+    }
+}
@@ -134,12 +134,17 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBOptions& db_options)
 {
+    assert(db_options.write_buffer_percent > 0 && db_options.write_buffer_percent < 50);
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    options.write_buffer_size = nCacheSize / 100 * db_options.write_buffer_percent;
+    options.block_cache = leveldb::NewLRUCache(nCacheSize - 2 * options.write_buffer_size); // up to two write buffers may be held in memory simultaneously
+    options.max_file_size = db_options.max_file_size;
+    options.block_size = db_options.block_size;
+    if (db_options.bloom_filter_bits > 0) {
+        options.filter_policy = leveldb::NewBloomFilterPolicy(db_options.bloom_filter_bits);
+    }
     options.compression = leveldb::kNoCompression;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -226,7 +231,7 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     DBContext().iteroptions.verify_checksums = true;
     DBContext().iteroptions.fill_cache = false;
     DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
+    DBContext().options = GetOptions(params.cache_bytes, params.options);
     DBContext().options.create_if_missing = true;
     if (params.memory_only) {
         DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -249,9 +254,7 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     LogPrintf("Opened LevelDB successfully\n");
 
     if (params.options.force_compact) {
-        LogPrintf("Starting database compaction of %s\n", fs::PathToString(params.path));
-        DBContext().pdb->CompactRange(nullptr, nullptr);
-        LogPrintf("Finished database compaction of %s\n", fs::PathToString(params.path));
+        CompactFull();
     }
 
     // The base-case obfuscation key, which is a noop.
@@ -316,6 +319,13 @@ size_t CDBWrapper::DynamicMemoryUsage() const
     return parsed.value();
 }
 
+void CDBWrapper::CompactFull()
+{
+    LogPrintf("Starting database compaction of %s\n", fs::PathToString(m_path));
+    DBContext().pdb->CompactRange(nullptr, nullptr);
+    LogPrintf("Finished database compaction of %s\n", fs::PathToString(m_path));
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -22,11 +22,32 @@
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
+//! Default size at which LevelDB starts a new table file, LevelDB's own.
+static const size_t DBWRAPPER_MAX_FILE_SIZE = 2 << 20;
+//! Default number of bloom filter bits per key.
+static const int DBWRAPPER_BLOOM_FILTER_BITS = 10;
+//! Default size of the table file blocks, LevelDB's own.
+static const size_t DBWRAPPER_BLOCK_SIZE = 4 << 10;
+//! Default share of the cache taken by each write buffer, in percent.
+static const int DBWRAPPER_WRITE_BUFFER_PERCENT = 25;
 
 //! User-controlled performance and debug options.
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Maximum size of a single table file in bytes.
+    size_t max_file_size = DBWRAPPER_MAX_FILE_SIZE;
+    //! Bits per key of the bloom filter used to skip table reads for absent
+    //! keys, or 0 to not use a bloom filter.
+    int bloom_filter_bits = DBWRAPPER_BLOOM_FILTER_BITS;
+    //! Approximate size in bytes of the data packed into a block, the unit in
+    //! which table files are read and cached. Smaller blocks suit point
+    //! lookups, larger ones iteration over consecutive keys.
+    size_t block_size = DBWRAPPER_BLOCK_SIZE;
+    //! Share of the cache, in percent, taken by each write buffer. Up to two
+    //! of them may be held in memory simultaneously and the rest of the cache
+    //! is the block cache, so this must be below 50.
+    int write_buffer_percent = DBWRAPPER_WRITE_BUFFER_PERCENT;
 };
 
 //! Application-specific storage settings.
@@ -275,6 +296,9 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    //! Compact the whole database. This may take a long time on a large database.
+    void CompactFull();
+
     CDBIterator* NewIterator();
 
     /**
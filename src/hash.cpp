@@ -82,6 +82,68 @@ uint256 SHA256Uint256(const uint256& input)
     return result;
 }
 
+namespace {
+/** Compute the SHA256 of each input into consecutive 32-byte outputs. */
+void SHA256Inputs(unsigned char* output, Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<const unsigned char*> data;
+    std::vector<size_t> lengths;
+    data.reserve(inputs.size());
+    lengths.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        data.push_back(input.data());
+        lengths.push_back(input.size());
+    }
+    SHA256Multi(output, data.data(), lengths.data(), inputs.size());
+}
+
+std::vector<uint256> ToUint256s(Span<const unsigned char> hashes)
+{
+    std::vector<uint256> ret;
+    ret.reserve(hashes.size() / CSHA256::OUTPUT_SIZE);
+    for (size_t i = 0; i < hashes.size(); i += CSHA256::OUTPUT_SIZE) {
+        ret.emplace_back(hashes.subspan(i, CSHA256::OUTPUT_SIZE));
+    }
+    return ret;
+}
+} // namespace
+
+std::vector<uint160> Hash160Batch(Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<unsigned char> sha256(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Inputs(sha256.data(), inputs);
+    std::vector<unsigned char> ripemd160(inputs.size() * CRIPEMD160::OUTPUT_SIZE);
+    RIPEMD160_32(ripemd160.data(), sha256.data(), inputs.size());
+
+    std::vector<uint160> ret;
+    ret.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        ret.emplace_back(Span{ripemd160}.subspan(i * CRIPEMD160::OUTPUT_SIZE, CRIPEMD160::OUTPUT_SIZE));
+    }
+    return ret;
+}
+
+std::vector<uint256> HashBatch(Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<unsigned char> sha256(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Inputs(sha256.data(), inputs);
+    std::vector<Span<const unsigned char>> first;
+    first.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        first.push_back(Span{sha256}.subspan(i * CSHA256::OUTPUT_SIZE, CSHA256::OUTPUT_SIZE));
+    }
+    std::vector<unsigned char> sha256d(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Inputs(sha256d.data(), first);
+    return ToUint256s(sha256d);
+}
+
+std::vector<uint256> SHA256Batch(Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<unsigned char> sha256(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Inputs(sha256.data(), inputs);
+    return ToUint256s(sha256);
+}
+
 HashWriter TaggedHash(const std::string& tag)
 {
     HashWriter writer{};
@@ -96,6 +96,18 @@ inline uint160 Hash160(const T1& in1)
     return result;
 }
 
+/** Compute the 160-bit hashes of several objects. The SHA-256 and RIPEMD-160
+ *  steps are computed several at a time where the CPU allows it. */
+std::vector<uint160> Hash160Batch(Span<const Span<const unsigned char>> inputs);
+
+/** Compute the 256-bit hashes of several objects, several at a time where the
+ *  CPU allows it. */
+std::vector<uint256> HashBatch(Span<const Span<const unsigned char>> inputs);
+
+/** Compute the single SHA256 of several objects, several at a time where the
+ *  CPU allows it. */
+std::vector<uint256> SHA256Batch(Span<const Span<const unsigned char>> inputs);
+
 /** A writer stream (for serialization) that computes a 256-bit hash. */
 class HashWriter
 {
@@ -207,6 +207,9 @@ private:
     /** Return a set of headers that satisfy our proof-of-work threshold */
     std::vector<CBlockHeader> PopHeadersReadyForAcceptance();
 
+    /** Return the work of a header with the given nBits (see GetBlockProof) */
+    arith_uint256 GetHeaderWork(uint32_t nBits);
+
 private:
     /** NodeId of the peer (used for log messages) **/
     const NodeId m_id;
@@ -265,6 +268,12 @@ private:
     /** The accumulated work on the redownloaded chain. */
     arith_uint256 m_redownload_chain_work;
 
+    /** nBits of the last header whose work was computed, and that work. The
+     * target only changes at difficulty adjustments, so this saves computing
+     * the work for almost every header in both phases. */
+    uint32_t m_last_work_bits{0};
+    arith_uint256 m_last_header_work{0};
+
     /** Set this to true once we encounter the target blockheader during phase
      * 2 (REDOWNLOAD). At this point, we can process and store all remaining
      * headers still in m_redownloaded_headers.
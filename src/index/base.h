@@ -53,7 +53,8 @@ protected:
     {
     public:
         DB(const fs::path& path, size_t n_cache_size,
-           bool f_memory = false, bool f_wipe = false, bool f_obfuscate = false);
+           bool f_memory = false, bool f_wipe = false, bool f_obfuscate = false,
+           const DBOptions& options = {});
 
         /// Read block locator of the chain that the index is in sync with.
         bool ReadBestBlock(CBlockLocator& locator) const;
@@ -162,6 +163,9 @@ public:
 
     /// Get a summary of the index and its state.
     IndexSummary GetSummary() const;
+
+    /// Compact the index database. This may take a long time on a large index.
+    void CompactDB() { GetDB().CompactFull(); }
 };
 
 #endif // BITCOIN_INDEX_BASE_H
@@ -19,6 +19,10 @@ static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
+/** LevelDB settings of the block filter index databases. Filter headers and positions are mostly
+ *  read for ranges of consecutive heights, which larger blocks serve with fewer reads. */
+static constexpr DBOptions BLOCK_FILTER_INDEX_DB_OPTIONS{.block_size = 16 << 10};
+
 /**
  * BlockFilterIndex is used to store and retrieve block filters, hashes, and headers for a range of
  * blocks by height. An index is constructed for each supported filter type with its own database
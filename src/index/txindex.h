@@ -9,6 +9,11 @@
 
 static constexpr bool DEFAULT_TXINDEX{false};
 
+//! LevelDB settings of the txindex. While syncing, it writes every key once in
+//! random order and reads few of them back, so the write buffers get most of
+//! its cache, which makes for fewer and larger level-0 files to compact.
+static constexpr DBOptions TXINDEX_DB_OPTIONS{.write_buffer_percent = 40};
+
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
  * The index is written to a LevelDB database and records the filesystem
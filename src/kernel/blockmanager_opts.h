@@ -15,6 +15,7 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+static constexpr int DEFAULT_BLOCKS_ARCHIVE_DEPTH{10000};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -27,6 +28,10 @@ struct BlockManagerOpts {
     bool fast_prune{false};
     const fs::path blocks_dir;
     Notifications& notifications;
+    //! Directory block and undo files are moved to once all their blocks are
+    //! blocks_archive_depth blocks deep. Disabled if empty.
+    fs::path blocks_archive_dir{};
+    int blocks_archive_depth{DEFAULT_BLOCKS_ARCHIVE_DEPTH};
 };
 
 } // namespace kernel
@@ -42,8 +42,8 @@ struct ChainstateManagerOpts {
     std::optional<uint256> assumed_valid_block{};
     //! If the tip is older than this, the node is considered to be in initial block download.
     std::chrono::seconds max_tip_age{DEFAULT_MAX_TIP_AGE};
-    DBOptions block_tree_db{};
-    DBOptions coins_db{};
+    DBOptions block_tree_db{BLOCK_TREE_DB_OPTIONS};
+    DBOptions coins_db{COINS_DB_OPTIONS};
     CoinsViewOptions coins_view{};
     Notifications& notifications;
     ValidationSignals* signals{nullptr};
@@ -20,15 +20,21 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/threadnames.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -55,7 +61,7 @@ static void TxOutSer(T& ss, const COutPoint& outpoint, const Coin& coin)
     ss << coin.out;
 }
 
-static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
 {
     TxOutSer(ss, outpoint, coin);
 }
@@ -76,6 +82,133 @@ void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& c
 
 static void ApplyCoinHash(std::nullptr_t, const COutPoint& outpoint, const Coin& coin) {}
 
+namespace {
+/**
+ * MuHash3072 accumulator that spreads the per-coin work (hashing each coin
+ * into a Num3072 and multiplying it in) over several worker threads.
+ *
+ * Since MuHash is commutative, every worker keeps its own partial product
+ * over an arbitrary subset of the coins, and the partial products are
+ * multiplied together when the hash is finalized.
+ */
+class ParallelMuHash
+{
+    //! Serialized coins handed to a worker at once.
+    struct Batch {
+        DataStream data{};
+        std::vector<size_t> ends;
+    };
+
+    static constexpr size_t BATCH_SIZE{1024};
+    static constexpr size_t MAX_PENDING_BATCHES_PER_WORKER{4};
+    static constexpr unsigned int MAX_WORKER_THREADS{16};
+
+    Mutex m_mutex;
+    std::condition_variable m_worker_cv;
+    std::condition_variable m_producer_cv;
+    std::deque<Batch> m_pending GUARDED_BY(m_mutex);
+    bool m_request_stop GUARDED_BY(m_mutex){false};
+
+    //! Partial products, one per worker thread plus one for the calling thread.
+    std::vector<MuHash3072> m_partials;
+    std::vector<std::thread> m_worker_threads;
+    Batch m_current;
+
+    static void Process(MuHash3072& muhash, const Batch& batch)
+    {
+        const auto data{MakeUCharSpan(batch.data)};
+        size_t begin{0};
+        for (const size_t end : batch.ends) {
+            muhash.Insert(data.subspan(begin, end - begin));
+            begin = end;
+        }
+    }
+
+    void Loop(MuHash3072& muhash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            Batch batch;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_pending.empty() || m_request_stop; });
+                if (m_pending.empty()) return;
+                batch = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+            m_producer_cv.notify_one();
+            Process(muhash, batch);
+        }
+    }
+
+    void Dispatch() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_worker_threads.empty()) {
+            Process(m_partials.front(), m_current);
+        } else {
+            WAIT_LOCK(m_mutex, lock);
+            m_producer_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                return m_pending.size() < MAX_PENDING_BATCHES_PER_WORKER * m_worker_threads.size();
+            });
+            m_pending.push_back(std::move(m_current));
+            m_worker_cv.notify_one();
+        }
+        m_current = Batch{};
+    }
+
+    void StopWorkers() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_request_stop = true);
+        m_worker_cv.notify_all();
+        for (std::thread& t : m_worker_threads) t.join();
+        m_worker_threads.clear();
+    }
+
+public:
+    ParallelMuHash()
+    {
+        const unsigned int worker_threads_num{std::min(std::max(1U, std::thread::hardware_concurrency()), MAX_WORKER_THREADS + 1) - 1};
+        m_partials.resize(worker_threads_num + 1);
+        m_worker_threads.reserve(worker_threads_num);
+        for (unsigned int n = 0; n < worker_threads_num; ++n) {
+            m_worker_threads.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("muhash.%i", n));
+                Loop(m_partials[n + 1]);
+            });
+        }
+    }
+
+    ~ParallelMuHash()
+    {
+        // Workers drain the queue before exiting, which is wasted work if we
+        // are unwinding due to an interruption, so drop what's left first.
+        WITH_LOCK(m_mutex, m_pending.clear());
+        StopWorkers();
+    }
+
+    void Insert(const COutPoint& outpoint, const Coin& coin) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        TxOutSer(m_current.data, outpoint, coin);
+        m_current.ends.push_back(m_current.data.size());
+        if (m_current.ends.size() == BATCH_SIZE) Dispatch();
+    }
+
+    void Finalize(uint256& out) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Process(m_partials.front(), m_current);
+        m_current = Batch{};
+        StopWorkers();
+        for (size_t i = 1; i < m_partials.size(); ++i) m_partials.front() *= m_partials[i];
+        m_partials.front().Finalize(out);
+    }
+};
+
+} // namespace
+
+static void ApplyCoinHash(ParallelMuHash& muhash, const COutPoint& outpoint, const Coin& coin)
+{
+    muhash.Insert(outpoint, coin);
+}
+
 //! Warning: be very careful when changing this! assumeutxo and UTXO snapshot
 //! validation commitments are reliant on the hash constructed by this
 //! function.
@@ -89,7 +222,7 @@ static void ApplyCoinHash(std::nullptr_t, const COutPoint& outpoint, const Coin&
 //! construction could cause a previously invalid (and potentially malicious)
 //! UTXO snapshot to be considered valid.
 template <typename T>
-static void ApplyHash(T& hash_obj, const Txid& hash, const std::map<uint32_t, Coin>& outputs)
+static void ApplyHash(T&& hash_obj, const Txid& hash, const std::map<uint32_t, Coin>& outputs)
 {
     for (auto it = outputs.begin(); it != outputs.end(); ++it) {
         COutPoint outpoint = COutPoint(hash, it->first);
@@ -113,7 +246,7 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
 
 //! Calculate statistics about the unspent transaction output set
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T&& hash_obj, const std::function<void()>& interruption_point)
 {
     std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
     assert(pcursor);
@@ -163,7 +296,7 @@ std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsV
             return ComputeUTXOStats(view, stats, ss, interruption_point);
         }
         case(CoinStatsHashType::MUHASH): {
-            MuHash3072 muhash;
+            ParallelMuHash muhash;
             return ComputeUTXOStats(view, stats, muhash, interruption_point);
         }
         case(CoinStatsHashType::NONE): {
@@ -183,11 +316,9 @@ static void FinalizeHash(HashWriter& ss, CCoinsStats& stats)
 {
     stats.hashSerialized = ss.GetHash();
 }
-static void FinalizeHash(MuHash3072& muhash, CCoinsStats& stats)
+static void FinalizeHash(ParallelMuHash& muhash, CCoinsStats& stats)
 {
-    uint256 out;
-    muhash.Finalize(out);
-    stats.hashSerialized = out;
+    muhash.Finalize(stats.hashSerialized);
 }
 static void FinalizeHash(std::nullptr_t, CCoinsStats& stats) {}
 
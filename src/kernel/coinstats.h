@@ -18,6 +18,7 @@ class CCoinsView;
 class Coin;
 class COutPoint;
 class CScript;
+class HashWriter;
 namespace node {
 class BlockManager;
 } // namespace node
@@ -73,6 +74,7 @@ struct CCoinsStats {
 
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
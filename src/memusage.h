@@ -9,6 +9,7 @@
 #include <prevector.h>
 #include <support/allocators/pool.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <list>
@@ -26,6 +27,15 @@ namespace memusage
 /** Compute the total memory used by allocating alloc bytes. */
 static size_t MallocUsage(size_t alloc);
 
+/** Compute the memory used by allocating alloc bytes from a PoolResource with the given alignment,
+ *  which rounds up to its element alignment but keeps no per-allocation bookkeeping. */
+template <std::size_t ALIGN_BYTES>
+static constexpr size_t PoolUsage(size_t alloc)
+{
+    constexpr size_t elem_align{std::max(alignof(void*), ALIGN_BYTES)};
+    return (alloc + elem_align - 1) / elem_align * elem_align;
+}
+
 /** Dynamic memory usage for built-in types is zero. */
 static inline size_t DynamicUsage(const int8_t& v) { return 0; }
 static inline size_t DynamicUsage(const uint8_t& v) { return 0; }
@@ -134,6 +144,12 @@ static inline size_t IncrementalDynamicUsage(const indirectmap<X, Y>& m)
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X*, Y> >));
 }
 
+template <typename X, typename Y, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+static inline size_t DynamicUsage(const indirectmap<X, Y, PoolAllocator<std::pair<const X* const, Y>, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>>& m)
+{
+    return PoolUsage<ALIGN_BYTES>(sizeof(stl_tree_node<std::pair<const X*, Y>>)) * m.size();
+}
+
 template<typename X>
 static inline size_t DynamicUsage(const std::unique_ptr<X>& p)
 {
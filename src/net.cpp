@@ -956,6 +956,20 @@ std::vector<uint8_t> GenerateRandomGarbage() noexcept
     return ret;
 }
 
+/** V2 receive buffers up to this capacity are kept across packets rather than released, as nearly
+ *  all messages fit and reallocating them for every packet is wasteful. */
+constexpr size_t V2_RECV_BUFFER_KEEP_SIZE{4096};
+
+/** Empty a V2 receive buffer, only releasing its memory if it outgrew V2_RECV_BUFFER_KEEP_SIZE. */
+void ClearRecvBuffer(std::vector<uint8_t>& buffer) noexcept
+{
+    if (buffer.capacity() > V2_RECV_BUFFER_KEEP_SIZE) {
+        ClearShrink(buffer);
+    } else {
+        buffer.clear();
+    }
+}
+
 } // namespace
 
 void V2Transport::StartSendingHandshake() noexcept
@@ -1233,9 +1247,9 @@ bool V2Transport::ProcessReceivedPacketBytes() noexcept
             }
         }
         // Wipe the receive buffer where the next packet will be received into.
-        ClearShrink(m_recv_buffer);
+        ClearRecvBuffer(m_recv_buffer);
         // In all but APP_READY state, we can wipe the decoded contents.
-        if (m_recv_state != RecvState::APP_READY) ClearShrink(m_recv_decode_buffer);
+        if (m_recv_state != RecvState::APP_READY) ClearRecvBuffer(m_recv_decode_buffer);
     } else {
         // We either have less than 3 bytes, so we don't know the packet's length yet, or more
         // than 3 bytes but less than the packet's full ciphertext. Wait until those arrive.
@@ -1431,7 +1445,7 @@ CNetMessage V2Transport::GetReceivedMessage(std::chrono::microseconds time, bool
     Assume(m_recv_state == RecvState::APP_READY);
     Span<const uint8_t> contents{m_recv_decode_buffer};
     auto msg_type = GetMessageType(contents);
-    CNetMessage msg{DataStream{}};
+    CNetMessage msg{DataStream{PUBLIC_DATA}};
     // Note that BIP324Cipher::EXPANSION also includes the length descriptor size.
     msg.m_raw_message_size = m_recv_decode_buffer.size() + BIP324Cipher::EXPANSION;
     if (msg_type) {
@@ -1445,7 +1459,7 @@ CNetMessage V2Transport::GetReceivedMessage(std::chrono::microseconds time, bool
         LogDebug(BCLog::NET, "V2 transport error: invalid message type (%u bytes contents), peer=%d\n", m_recv_decode_buffer.size(), m_nodeid);
         reject_message = true;
     }
-    ClearShrink(m_recv_decode_buffer);
+    ClearRecvBuffer(m_recv_decode_buffer);
     SetReceiveState(RecvState::APP);
 
     return msg;
@@ -370,9 +370,9 @@ private:
     mutable CHash256 hasher GUARDED_BY(m_recv_mutex);
     mutable uint256 data_hash GUARDED_BY(m_recv_mutex);
     bool in_data GUARDED_BY(m_recv_mutex); // parsing header (false) or data (true)
-    DataStream hdrbuf GUARDED_BY(m_recv_mutex){}; // partially received header
+    DataStream hdrbuf GUARDED_BY(m_recv_mutex){PUBLIC_DATA}; // partially received header
     CMessageHeader hdr GUARDED_BY(m_recv_mutex); // complete header
-    DataStream vRecv GUARDED_BY(m_recv_mutex){}; // received message data
+    DataStream vRecv GUARDED_BY(m_recv_mutex){PUBLIC_DATA}; // received message data
     unsigned int nHdrPos GUARDED_BY(m_recv_mutex);
     unsigned int nDataPos GUARDED_BY(m_recv_mutex);
 
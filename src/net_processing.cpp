@@ -22,6 +22,7 @@
 #include <merkleblock.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
+#include <node/blockdownloadwindow.h>
 #include <node/blockstorage.h>
 #include <node/timeoffsets.h>
 #include <node/txreconciliation.h>
@@ -29,6 +30,7 @@
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/settings.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -106,8 +108,6 @@ static constexpr auto OVERLOADED_PEER_TX_DELAY{2s};
 static constexpr auto GETDATA_TX_INTERVAL{60s};
 /** Limit to avoid sending big packets. Not used in processing incoming GETDATA for compatibility */
 static const unsigned int MAX_GETDATA_SZ = 1000;
-/** Number of blocks that can be requested at any given time from a single peer. */
-static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Default time during which a peer must stall block download progress before being disconnected.
  * the actual timeout is increased temporarily if peers are disconnected for hitting the timeout */
 static constexpr auto BLOCK_STALLING_TIMEOUT_DEFAULT{2s};
@@ -119,6 +119,10 @@ static const int MAX_CMPCTBLOCK_DEPTH = 5;
 /** Maximum depth of blocks we're willing to respond to GETBLOCKTXN requests for. */
 static const int MAX_BLOCKTXN_DEPTH = 10;
 static_assert(MAX_BLOCKTXN_DEPTH <= MIN_BLOCKS_TO_KEEP, "MAX_BLOCKTXN_DEPTH too high");
+/** Maximum total size of the transactions, besides the coinbase, that we prefill in a compact block
+ *  because we predict the peer to be missing them. A correct prediction saves the peer a GETBLOCKTXN
+ *  round trip; a wrong one makes the announcement larger. */
+static constexpr size_t MAX_CMPCTBLOCK_PREDICTED_PREFILL_SIZE{10'000};
 /** Size of the "block download window": how far ahead of our current height do we fetch?
  *  Larger windows tolerate larger download speed differences between peer, but increase the potential
  *  degree of disordering of blocks on disk (which make reindexing and pruning harder). We'll probably
@@ -186,6 +190,8 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the block was requested. */
+    std::chrono::microseconds m_requested_time;
 };
 
 /**
@@ -431,6 +437,8 @@ struct CNodeState {
     std::list<QueuedBlock> vBlocksInFlight;
     //! When the first entry in vBlocksInFlight started downloading. Don't care when vBlocksInFlight is empty.
     std::chrono::microseconds m_downloading_since{0us};
+    //! How many blocks can be in flight from this peer, adapted to its measured download speed.
+    BlockDownloadWindow m_block_download;
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload{false};
     /** Whether this peer wants invs or cmpctblocks (when possible) for block announcements. */
@@ -663,8 +671,6 @@ private:
      * non-connecting headers (this can happen due to BIP 130 headers
      * announcements for blocks interacting with the 2hr (MAX_FUTURE_BLOCK_TIME) rule). */
     void HandleUnconnectingHeaders(CNode& pfrom, Peer& peer, const std::vector<CBlockHeader>& headers) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
-    /** Return true if the headers connect to each other, false otherwise */
-    bool CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers) const;
     /** Try to continue a low-work headers sync that has already begun.
      * Assumes the caller has already verified the headers connect, and has
      * checked that each header satisfies the proof-of-work target included in
@@ -1029,6 +1035,10 @@ private:
      */
     bool BlockRequested(NodeId nodeid, const CBlockIndex& block, std::list<QueuedBlock>::iterator** pit = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Update the download measurements of a peer that sent us a block we requested from it.
+     *  Must be called before the request is removed. */
+    void BlockReceived(const CNode& node, const uint256& hash, size_t block_size, std::chrono::microseconds time_received) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     bool TipMayBeStale() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     /** Update pindexLastCommonBlock and add not-in-flight missing successors to vBlocks, until it has
@@ -1258,6 +1268,48 @@ static void AddKnownTx(Peer& peer, const uint256& hash)
     tx_relay->m_tx_inventory_known_filter.insert(hash);
 }
 
+/** Queue transactions a reconciliation found the peer to be missing for announcement. */
+static void AnnounceReconciledTxs(Peer& peer, const std::vector<Wtxid>& wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay) return;
+
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    for (const Wtxid& wtxid : wtxids) {
+        if (!tx_relay->m_tx_inventory_known_filter.contains(wtxid.ToUint256())) {
+            tx_relay->m_tx_inventory_to_send.insert(wtxid.ToUint256());
+        }
+    }
+}
+
+/**
+ * Predict which of a block's transactions, after the coinbase, a peer is missing, so that the compact
+ * block announcing it can prefill them: those still queued for announcement to the peer, which
+ * neither we nor the peer announced to the other yet. The known inventory filter alone is no
+ * evidence, as it forgets old announcements, and transactions announced through reconciliation are
+ * not queued. Returns the increasing indexes of the predicted transactions that fit in the budget.
+ */
+static std::vector<uint16_t> PredictMissingTxs(Peer& peer, const CBlock& block)
+{
+    std::vector<uint16_t> indexes;
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay) return indexes;
+
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    if (tx_relay->m_tx_inventory_to_send.empty()) return indexes;
+    size_t prefill_bytes{0};
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        const uint256& hash{peer.m_wtxid_relay ? tx.GetWitnessHash().ToUint256() : tx.GetHash().ToUint256()};
+        if (!tx_relay->m_tx_inventory_to_send.contains(hash) || tx_relay->m_tx_inventory_known_filter.contains(hash)) continue;
+        const size_t tx_size{tx.GetTotalSize()};
+        if (prefill_bytes + tx_size > MAX_CMPCTBLOCK_PREDICTED_PREFILL_SIZE) continue;
+        prefill_bytes += tx_size;
+        indexes.push_back(i);
+    }
+    return indexes;
+}
+
 /** Whether this peer can serve us blocks. */
 static bool CanServeBlocks(const Peer& peer)
 {
@@ -1365,11 +1417,12 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     // Make sure it's not being fetched already from same peer.
     RemoveBlockRequest(hash, nodeid);
 
+    const auto now{GetTime<std::chrono::microseconds>()};
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr)});
+            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr), now});
     if (state->vBlocksInFlight.size() == 1) {
         // We're starting a block download (batch) from this peer.
-        state->m_downloading_since = GetTime<std::chrono::microseconds>();
+        state->m_downloading_since = now;
         m_peers_downloading_from++;
     }
     auto itInFlight = mapBlocksInFlight.insert(std::make_pair(hash, std::make_pair(nodeid, it)));
@@ -1379,6 +1432,19 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     return true;
 }
 
+void PeerManagerImpl::BlockReceived(const CNode& node, const uint256& hash, size_t block_size, std::chrono::microseconds time_received)
+{
+    for (auto range = mapBlocksInFlight.equal_range(hash); range.first != range.second; range.first++) {
+        auto [node_id, list_it] = range.first->second;
+        if (node_id != node.GetId()) continue;
+
+        const auto min_ping_time{node.m_min_ping_time.load()};
+        Assert(State(node_id))->m_block_download.BlockReceived(list_it->m_requested_time, time_received, block_size,
+            min_ping_time == std::chrono::microseconds::max() ? std::nullopt : std::optional{min_ping_time});
+        return;
+    }
+}
+
 void PeerManagerImpl::MaybeSetPeerAsAnnouncingHeaderAndIDs(NodeId nodeid)
 {
     AssertLockHeld(cs_main);
@@ -1878,6 +1944,7 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
             if (queue.pindex)
                 stats.vHeightInFlight.push_back(queue.pindex->nHeight);
         }
+        stats.m_block_download = state->m_block_download.GetStats();
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -2091,8 +2158,8 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
       m_warnings{warnings},
       m_opts{opts}
 {
-    // While Erlay support is incomplete, it must be enabled explicitly via -txreconciliation.
-    // This argument can go away after Erlay support is complete.
+    // Erlay is opt-in until it has seen more deployment: it must be enabled explicitly via
+    // -txreconciliation.
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
@@ -2220,7 +2287,7 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
         m_most_recent_block_txs = std::move(most_recent_block_txs);
     }
 
-    m_connman.ForEachNode([this, pindex, &lazy_ser, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    m_connman.ForEachNode([this, pindex, &pblock, &pcmpctblock, &lazy_ser, &hashBlock](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
 
         if (pnode->GetCommonVersion() < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect)
@@ -2234,8 +2301,14 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
             LogDebug(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerManager::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
 
-            const CSerializedNetMsg& ser_cmpctblock{lazy_ser.get()};
-            PushMessage(*pnode, ser_cmpctblock.Copy());
+            PeerRef peer{GetPeerRef(pnode->GetId())};
+            const std::vector<uint16_t> predicted{peer ? PredictMissingTxs(*peer, *pblock) : std::vector<uint16_t>{}};
+            if (!predicted.empty()) {
+                MakeAndPushMessage(*pnode, NetMsgType::CMPCTBLOCK, CBlockHeaderAndShortTxIDs{*pcmpctblock, *pblock, predicted});
+            } else {
+                const CSerializedNetMsg& ser_cmpctblock{lazy_ser.get()};
+                PushMessage(*pnode, ser_cmpctblock.Copy());
+            }
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -2365,6 +2438,19 @@ void PeerManagerImpl::SendPings()
 void PeerManagerImpl::RelayTransaction(const uint256& txid, const uint256& wtxid)
 {
     LOCK(m_peer_mutex);
+
+    // Transactions are announced to the peers we reconcile with through reconciliation, except
+    // for a few of these peers to which they are flooded so that they keep propagating quickly.
+    std::vector<NodeId> fanout_targets;
+    if (m_txreconciliation) {
+        size_t inbounds_flooding{0}, outbounds_flooding{0};
+        for (const auto& [peer_id, peer] : m_peer_map) {
+            if (!peer->GetTxRelay() || m_txreconciliation->IsPeerRegistered(peer_id)) continue;
+            ++(peer->m_is_inbound ? inbounds_flooding : outbounds_flooding);
+        }
+        fanout_targets = m_txreconciliation->GetFanoutTargets(Wtxid::FromUint256(wtxid), inbounds_flooding, outbounds_flooding);
+    }
+
     for(auto& it : m_peer_map) {
         Peer& peer = *it.second;
         auto tx_relay = peer.GetTxRelay();
@@ -2380,6 +2466,11 @@ void PeerManagerImpl::RelayTransaction(const uint256& txid, const uint256& wtxid
 
         const uint256& hash{peer.m_wtxid_relay ? wtxid : txid};
         if (!tx_relay->m_tx_inventory_known_filter.contains(hash)) {
+            if (m_txreconciliation &&
+                std::find(fanout_targets.begin(), fanout_targets.end(), peer.m_id) == fanout_targets.end() &&
+                m_txreconciliation->AddToSet(peer.m_id, Wtxid::FromUint256(wtxid))) {
+                continue;
+            }
             tx_relay->m_tx_inventory_to_send.insert(hash);
         }
     };
@@ -2717,14 +2808,23 @@ void PeerManagerImpl::SendBlockTransactions(CNode& pfrom, Peer& peer, const CBlo
 
 bool PeerManagerImpl::CheckHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, Peer& peer)
 {
-    // Do these headers have proof-of-work matching what's claimed?
-    if (!HasValidProofOfWork(headers, consensusParams)) {
-        Misbehaving(peer, "header with invalid proof of work");
-        return false;
+    // Check that the headers have proof-of-work matching what's claimed, and that they are
+    // connected to each other, hashing each header only once.
+    bool continuous{true};
+    uint256 hashLastBlock;
+    for (const CBlockHeader& header : headers) {
+        const uint256 hash{header.GetHash()};
+        if (!CheckProofOfWork(hash, header.nBits, consensusParams)) {
+            Misbehaving(peer, "header with invalid proof of work");
+            return false;
+        }
+        if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+            continuous = false;
+        }
+        hashLastBlock = hash;
     }
 
-    // Are these headers connected to each other?
-    if (!CheckHeadersAreContinuous(headers)) {
+    if (!continuous) {
         Misbehaving(peer, "non-continuous headers sequence");
         return false;
     }
@@ -2769,18 +2869,6 @@ void PeerManagerImpl::HandleUnconnectingHeaders(CNode& pfrom, Peer& peer,
     WITH_LOCK(cs_main, UpdateBlockAvailability(pfrom.GetId(), headers.back().GetHash()));
 }
 
-bool PeerManagerImpl::CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers) const
-{
-    uint256 hashLastBlock;
-    for (const CBlockHeader& header : headers) {
-        if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
-            return false;
-        }
-        hashLastBlock = header.GetHash();
-    }
-    return true;
-}
-
 bool PeerManagerImpl::IsContinuationOfLowWorkHeadersSync(Peer& peer, CNode& pfrom, std::vector<CBlockHeader>& headers)
 {
     if (peer.m_headers_sync) {
@@ -2948,8 +3036,12 @@ void PeerManagerImpl::HeadersDirectFetchBlocks(CNode& pfrom, const Peer& peer, c
     if (CanDirectFetch() && last_header.IsValid(BLOCK_VALID_TREE) && m_chainman.ActiveChain().Tip()->nChainWork <= last_header.nChainWork) {
         std::vector<const CBlockIndex*> vToFetch;
         const CBlockIndex* pindexWalk{&last_header};
+        // Near the tip, new blocks are fetched as soon as they are announced, and a lower limit
+        // for a peer that is slow to deliver would only delay them: it is meant to keep such a
+        // peer from holding back the block download window.
+        const size_t max_blocks_in_transit{std::max(nodestate->m_block_download.GetLimit(), DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER)};
         // Calculate all the blocks we'd need to switch to last_header, up to a limit.
-        while (pindexWalk && !m_chainman.ActiveChain().Contains(pindexWalk) && vToFetch.size() <= MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        while (pindexWalk && !m_chainman.ActiveChain().Contains(pindexWalk) && vToFetch.size() <= max_blocks_in_transit) {
             if (!(pindexWalk->nStatus & BLOCK_HAVE_DATA) &&
                     !IsBlockRequested(pindexWalk->GetBlockHash()) &&
                     (!DeploymentActiveAt(*pindexWalk, m_chainman, Consensus::DEPLOYMENT_SEGWIT) || CanServeWitnesses(peer))) {
@@ -2970,7 +3062,7 @@ void PeerManagerImpl::HeadersDirectFetchBlocks(CNode& pfrom, const Peer& peer, c
             std::vector<CInv> vGetData;
             // Download as much as possible, from earliest to latest.
             for (const CBlockIndex* pindex : vToFetch | std::views::reverse) {
-                if (nodestate->vBlocksInFlight.size() >= MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+                if (nodestate->vBlocksInFlight.size() >= max_blocks_in_transit) {
                     // Can't download any more from this peer
                     break;
                 }
@@ -3100,6 +3192,20 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
     // REDOWNLOAD) can be validated without further anti-DoS checks.
     bool already_validated_work = false;
 
+    // A low-work headers sync is specific to this peer, but several peers
+    // usually present us the same chain. If these headers have already been
+    // accepted, e.g. through the headers sync with another peer, there is no
+    // need to download them again to check the commitments: abandon the sync,
+    // and process them as usual.
+    if (WITH_LOCK(peer.m_headers_sync_mutex, return peer.m_headers_sync != nullptr) &&
+        WITH_LOCK(::cs_main, return IsAncestorOfBestHeaderOrTip(m_chainman.m_blockman.LookupBlockIndex(headers.back().GetHash())))) {
+        LOCK(peer.m_headers_sync_mutex);
+        peer.m_headers_sync.reset(nullptr);
+        LOCK(m_headers_presync_mutex);
+        m_headers_presync_stats.erase(pfrom.GetId());
+        LogDebug(BCLog::NET, "Initial headers sync with peer=%d ended: received headers we already accepted\n", pfrom.GetId());
+    }
+
     // If we're in the middle of headers sync, let it do its magic.
     bool have_headers_sync = false;
     {
@@ -4272,6 +4378,10 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 LogDebug(BCLog::NET, "got inv: %s  %s peer=%d\n", inv.ToString(), fAlreadyHave ? "have" : "new", pfrom.GetId());
 
                 AddKnownTx(*peer, inv.hash);
+                if (m_txreconciliation && inv.IsMsgWtx()) {
+                    // The peer has the transaction, so there is no need to reconcile it.
+                    m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
+                }
                 if (!fAlreadyHave && !m_chainman.IsInitialBlockDownload()) {
                     AddTxAnnouncement(pfrom, gtxid, current_time);
                 }
@@ -4691,7 +4801,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 m_txrequest.ForgetTxHash(tx.GetWitnessHash());
 
                 // DoS prevention: do not allow m_orphanage to grow unbounded (see CVE-2012-3789)
-                m_orphanage.LimitOrphans(m_opts.max_orphan_txs, m_rng);
+                m_orphanage.LimitOrphans(m_opts.max_orphan_txs);
             } else {
                 LogDebug(BCLog::MEMPOOL, "not keeping orphan with rejected parents %s (wtxid=%s)\n",
                          tx.GetHash().ToString(),
@@ -4839,7 +4949,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         // We want to be a bit conservative just to be extra careful about DoS
         // possibilities in compact block processing...
         if (pindex->nHeight <= m_chainman.ActiveChain().Height() + 2) {
-            if ((already_in_flight < MAX_CMPCTBLOCKS_INFLIGHT_PER_BLOCK && nodestate->vBlocksInFlight.size() < MAX_BLOCKS_IN_TRANSIT_PER_PEER) ||
+            if ((already_in_flight < MAX_CMPCTBLOCKS_INFLIGHT_PER_BLOCK && nodestate->vBlocksInFlight.size() < std::max(nodestate->m_block_download.GetLimit(), DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER)) ||
                  requested_block_from_this_peer) {
                 std::list<QueuedBlock>::iterator* queuedBlockIt = nullptr;
                 if (!BlockRequested(pfrom.GetId(), *pindex, &queuedBlockIt)) {
@@ -5037,6 +5147,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             return;
         }
 
+        const size_t block_size{vRecv.size()};
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
         vRecv >> TX_WITH_WITNESS(*pblock);
 
@@ -5061,7 +5172,14 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             // Always process the block if we requested it, since we may
             // need it even when it's not a candidate for a new best tip.
             forceProcessing = IsBlockRequested(hash);
-            RemoveBlockRequest(hash, pfrom.GetId());
+            BlockReceived(pfrom, hash, block_size, time_received);
+            // If this peer delivers a block we requested from it, the block may also be in flight
+            // from a stalling peer we raced for it: drop that request too, which ends the stall.
+            // An unsolicited block leaves other peers' requests, including compact block
+            // reconstructions, untouched.
+            const auto range{mapBlocksInFlight.equal_range(hash)};
+            const bool requested_from_peer{std::any_of(range.first, range.second, [&](const auto& entry) { return entry.second.first == pfrom.GetId(); })};
+            RemoveBlockRequest(hash, requested_from_peer ? std::nullopt : std::optional<NodeId>{pfrom.GetId()});
             // mapBlockSource is only used for punishing peers and setting
             // which peers send us compact blocks, so the race between here and
             // cs_main in ProcessNewBlock is fine.
@@ -5289,6 +5407,66 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    // Messages of the reconciliation protocol (BIP 330) are ignored from peers we do not reconcile
+    // with, and any message out of sequence is a protocol violation.
+    if (msg_type == NetMsgType::REQRECON) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) return;
+        uint16_t peer_set_size, peer_q;
+        vRecv >> peer_set_size >> peer_q;
+        if (!m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_set_size, peer_q)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation from peer=%d (unexpected reqrecon); disconnecting\n", pfrom.GetId());
+            pfrom.fDisconnect = true;
+        }
+        // The sketch is sent along with the next inventory trickle, see SendMessages.
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) return;
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        const auto result{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)};
+        if (!result) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation from peer=%d (unexpected sketch); disconnecting\n", pfrom.GetId());
+            pfrom.fDisconnect = true;
+            return;
+        }
+        if (result->request_extension) {
+            MakeAndPushMessage(pfrom, NetMsgType::REQSKETCHEXT);
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{result->success}, result->txs_to_request);
+        AnnounceReconciledTxs(*peer, result->txs_to_announce);
+        return;
+    }
+
+    if (msg_type == NetMsgType::REQSKETCHEXT) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) return;
+        const auto skdata{m_txreconciliation->HandleSketchExtensionRequest(pfrom.GetId())};
+        if (!skdata) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation from peer=%d (unexpected reqsketchext); disconnecting\n", pfrom.GetId());
+            pfrom.fDisconnect = true;
+            return;
+        }
+        MakeAndPushMessage(pfrom, NetMsgType::SKETCH, *skdata);
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) return;
+        uint8_t success;
+        std::vector<uint32_t> ask_shortids;
+        vRecv >> success >> ask_shortids;
+        const auto txs_to_announce{m_txreconciliation->HandleReconciliationDifference(pfrom.GetId(), success != 0, ask_shortids)};
+        if (!txs_to_announce) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation from peer=%d (unexpected reconcildiff); disconnecting\n", pfrom.GetId());
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(*peer, *txs_to_announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::FEEFILTER) {
         CAmount newFeeFilter = 0;
         vRecv >> newFeeFilter;
@@ -6041,21 +6219,33 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     LogDebug(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", __func__,
                             vHeaders.front().GetHash().ToString(), pto->GetId());
 
-                    std::optional<CSerializedNetMsg> cached_cmpctblock_msg;
+                    std::shared_ptr<const CBlock> most_recent_block;
+                    std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block;
                     {
                         LOCK(m_most_recent_block_mutex);
                         if (m_most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            cached_cmpctblock_msg = NetMsg::Make(NetMsgType::CMPCTBLOCK, *m_most_recent_compact_block);
+                            most_recent_block = m_most_recent_block;
+                            most_recent_compact_block = m_most_recent_compact_block;
                         }
                     }
-                    if (cached_cmpctblock_msg.has_value()) {
-                        PushMessage(*pto, std::move(cached_cmpctblock_msg.value()));
+                    if (most_recent_block) {
+                        const std::vector<uint16_t> predicted{PredictMissingTxs(*peer, *most_recent_block)};
+                        if (!predicted.empty()) {
+                            MakeAndPushMessage(*pto, NetMsgType::CMPCTBLOCK, CBlockHeaderAndShortTxIDs{*most_recent_compact_block, *most_recent_block, predicted});
+                        } else {
+                            MakeAndPushMessage(*pto, NetMsgType::CMPCTBLOCK, *most_recent_compact_block);
+                        }
                     } else {
                         CBlock block;
                         const bool ret{m_chainman.m_blockman.ReadBlockFromDisk(block, *pBestIndex)};
                         assert(ret);
-                        CBlockHeaderAndShortTxIDs cmpctblock{block, m_rng.rand64()};
-                        MakeAndPushMessage(*pto, NetMsgType::CMPCTBLOCK, cmpctblock);
+                        const CBlockHeaderAndShortTxIDs cmpctblock{block, m_rng.rand64()};
+                        const std::vector<uint16_t> predicted{PredictMissingTxs(*peer, block)};
+                        if (!predicted.empty()) {
+                            MakeAndPushMessage(*pto, NetMsgType::CMPCTBLOCK, CBlockHeaderAndShortTxIDs{cmpctblock, block, predicted});
+                        } else {
+                            MakeAndPushMessage(*pto, NetMsgType::CMPCTBLOCK, cmpctblock);
+                        }
                     }
                     state.pindexBestHeaderSent = pBestIndex;
                 } else if (peer->m_prefers_headers) {
@@ -6172,6 +6362,15 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     }
                 }
 
+                // Answer a pending reconciliation request along with the trickle, so that the
+                // sketch does not reveal more about the time of arrival of transactions than an
+                // inventory announcement would.
+                if (fSendTrickle && m_txreconciliation) {
+                    if (const auto skdata{m_txreconciliation->RespondToReconciliationRequest(pto->GetId())}) {
+                        MakeAndPushMessage(*pto, NetMsgType::SKETCH, *skdata);
+                    }
+                }
+
                 // Determine transactions to relay
                 if (fSendTrickle) {
                     // Produce a vector with all candidates for sending
@@ -6232,6 +6431,18 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         if (!vInv.empty())
             MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
 
+        //
+        // Message: reqrecon
+        //
+        if (m_txreconciliation) {
+            if (const auto txs_to_announce{m_txreconciliation->ExpireReconciliation(pto->GetId(), current_time)}) {
+                AnnounceReconciledTxs(*peer, *txs_to_announce);
+            }
+            if (const auto request{m_txreconciliation->InitiateReconciliationRequest(pto->GetId(), current_time)}) {
+                MakeAndPushMessage(*pto, NetMsgType::REQRECON, request->set_size, request->q);
+            }
+        }
+
         // Detect whether we're stalling
         auto stalling_timeout = m_block_stalling_timeout.load();
         if (state.m_stalling_since.count() && state.m_stalling_since < current_time - stalling_timeout) {
@@ -6303,11 +6514,11 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        if (CanServeBlocks(*peer) && ((sync_blocks_and_headers_from_peer && !IsLimitedPeer(*peer)) || !m_chainman.IsInitialBlockDownload()) && state.vBlocksInFlight.size() < state.m_block_download.GetLimit()) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
             auto get_inflight_budget = [&state]() {
-                return std::max(0, MAX_BLOCKS_IN_TRANSIT_PER_PEER - static_cast<int>(state.vBlocksInFlight.size()));
+                return std::max(0, static_cast<int>(state.m_block_download.GetLimit()) - static_cast<int>(state.vBlocksInFlight.size()));
             };
 
             // If a snapshot chainstate is in use, we want to find its next blocks
@@ -6335,6 +6546,16 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     State(staller)->m_stalling_since = current_time;
                     LogDebug(BCLog::NET, "Stall started peer=%d\n", staller);
                 }
+                // The block download window cannot move until the staller delivers the first block
+                // we are missing. This peer is idle, so also race the staller for that block. If
+                // this peer delivers it first, every request for the block is dropped, which ends
+                // the stall: the staller is only disconnected if it stalls the window again.
+                const CBlockIndex* frontier{state.pindexBestKnownBlock->GetAncestor(state.pindexLastCommonBlock->nHeight + 1)};
+                if (frontier && mapBlocksInFlight.count(frontier->GetBlockHash()) == 1 && BlockRequested(pto->GetId(), *frontier)) {
+                    vGetData.emplace_back(MSG_BLOCK | GetFetchFlags(*peer), frontier->GetBlockHash());
+                    LogDebug(BCLog::NET, "Requesting block %s (%d) peer=%d, also in flight from stalling peer=%d\n",
+                        frontier->GetBlockHash().ToString(), frontier->nHeight, pto->GetId(), staller);
+                }
             }
         }
 
@@ -0,0 +1,61 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockdownloadwindow.h>
+
+#include <util/time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+void BlockDownloadWindow::BlockReceived(std::chrono::microseconds requested_time, std::chrono::microseconds now,
+                                        size_t block_size, std::optional<std::chrono::microseconds> rtt)
+{
+    ++m_blocks_received;
+    if (rtt) m_rtt = rtt;
+
+    // The peer cannot have started on this block before it was requested, nor before it finished
+    // sending the previous one.
+    const auto service_start{std::max(requested_time, m_last_received)};
+    m_last_received = std::max(m_last_received, now);
+    // Without time passing (e.g. under mocktime) there is nothing to measure.
+    if (now <= service_start) return;
+
+    const double service_secs{Ticks<SecondsDouble>(now - service_start)};
+    const double latency_secs{Ticks<SecondsDouble>(now - requested_time)};
+    if (!m_measured) {
+        m_avg_block_size = block_size;
+        m_avg_service_secs = service_secs;
+        m_avg_latency_secs = latency_secs;
+        m_measured = true;
+        return;
+    }
+    m_avg_block_size += SAMPLE_WEIGHT * (block_size - m_avg_block_size);
+    m_avg_service_secs += SAMPLE_WEIGHT * (service_secs - m_avg_service_secs);
+    m_avg_latency_secs += SAMPLE_WEIGHT * (latency_secs - m_avg_latency_secs);
+}
+
+size_t BlockDownloadWindow::GetLimit() const
+{
+    if (!m_measured || !m_rtt) return DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER;
+    // Twice the bandwidth-delay product, so that the limit keeps growing while the link idles for
+    // part of each round trip, plus the block being sent.
+    const double blocks_per_rtt{Ticks<SecondsDouble>(*m_rtt) / m_avg_service_secs};
+    const double limit{std::ceil(2 * blocks_per_rtt) + 1};
+    return std::clamp<double>(limit, MIN_BLOCKS_IN_TRANSIT_PER_PEER, MAX_BLOCKS_IN_TRANSIT_PER_PEER);
+}
+
+BlockDownloadStats BlockDownloadWindow::GetStats() const
+{
+    BlockDownloadStats stats;
+    stats.inflight_limit = GetLimit();
+    if (m_measured) {
+        stats.bytes_per_sec = m_avg_block_size / m_avg_service_secs;
+        stats.latency = std::chrono::duration_cast<std::chrono::microseconds>(SecondsDouble{m_avg_latency_secs});
+    }
+    stats.blocks_received = m_blocks_received;
+    return stats;
+}
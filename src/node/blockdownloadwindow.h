@@ -0,0 +1,80 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKDOWNLOADWINDOW_H
+#define BITCOIN_NODE_BLOCKDOWNLOADWINDOW_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/** Number of blocks that can be in flight from a peer before we have measured its download speed. */
+static constexpr size_t DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER{16};
+/** Lower bound on the number of blocks that can be in flight from a single peer. */
+static constexpr size_t MIN_BLOCKS_IN_TRANSIT_PER_PEER{4};
+/** Upper bound on the number of blocks that can be in flight from a single peer. */
+static constexpr size_t MAX_BLOCKS_IN_TRANSIT_PER_PEER{128};
+
+/** Block download measurements for a peer, see BlockDownloadWindow. */
+struct BlockDownloadStats {
+    /** Number of blocks we can currently have in flight from the peer. */
+    size_t inflight_limit{DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER};
+    /** Bytes per second the peer delivers while it has blocks in flight, if measured. */
+    std::optional<double> bytes_per_sec;
+    /** Average time from requesting a block to receiving it, if measured. */
+    std::optional<std::chrono::microseconds> latency;
+    /** Number of blocks received from the peer that we requested from it. */
+    uint64_t blocks_received{0};
+};
+
+/**
+ * Adaptive limit on the number of blocks we keep in flight from a single peer.
+ *
+ * A peer sends the blocks we ask for one after another. To keep its link busy, enough requests
+ * must be outstanding to cover the round trip between asking for a block and the peer starting to
+ * send it: the bandwidth-delay product, expressed in blocks. A fixed limit is too small for fast or
+ * distant peers, and too large for slow ones, which then hold back the block download window.
+ *
+ * Throughput is measured over the time the peer was busy with our requests: a block's service time
+ * runs from when it was requested, or from when the previous block arrived if that was later, until
+ * it arrives. While the limit is below the bandwidth-delay product, the link idles for part of each
+ * round trip, which shows up as service time, so the limit grows geometrically until the link is
+ * kept busy. The round trip time is the peer's minimum ping time, which unlike the block latency
+ * does not grow with the number of blocks queued at the peer.
+ *
+ * Not thread-safe; net_processing keeps one per peer, guarded by cs_main.
+ */
+class BlockDownloadWindow
+{
+    /** Weight of a new sample in the moving averages. */
+    static constexpr double SAMPLE_WEIGHT{1.0 / 8};
+
+    /** Moving averages of the block size, service time and latency, once there are samples. */
+    double m_avg_block_size{0};
+    double m_avg_service_secs{0};
+    double m_avg_latency_secs{0};
+    bool m_measured{false};
+
+    std::chrono::microseconds m_last_received{0};
+    std::optional<std::chrono::microseconds> m_rtt;
+    uint64_t m_blocks_received{0};
+
+public:
+    /**
+     * Record a block we requested from the peer at requested_time, received from it at now.
+     *
+     * @param[in] block_size  Serialized size of the block.
+     * @param[in] rtt         The peer's minimum ping time, if known.
+     */
+    void BlockReceived(std::chrono::microseconds requested_time, std::chrono::microseconds now,
+                       size_t block_size, std::optional<std::chrono::microseconds> rtt);
+
+    /** Number of blocks we can have in flight from the peer. */
+    size_t GetLimit() const;
+
+    BlockDownloadStats GetStats() const;
+};
+
+#endif // BITCOIN_NODE_BLOCKDOWNLOADWINDOW_H
@@ -4,9 +4,11 @@
 
 #include <node/blockmanager_args.h>
 
+#include <chainparamsbase.h>
 #include <common/args.h>
 #include <node/blockstorage.h>
 #include <tinyformat.h>
+#include <util/fs.h>
 #include <util/result.h>
 #include <util/translation.h>
 #include <validation.h>
@@ -34,6 +36,21 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
+    if (args.IsArgSet("-blocksarchivedir")) {
+        const fs::path archive_dir{fs::absolute(args.GetPathArg("-blocksarchivedir"))};
+        if (!fs::is_directory(archive_dir)) {
+            return util::Error{strprintf(_("Specified -blocksarchivedir \"%s\" does not exist."), fs::PathToString(archive_dir))};
+        }
+        if (opts.prune_target) {
+            return util::Error{_("-blocksarchivedir is incompatible with -prune.")};
+        }
+        opts.blocks_archive_dir = archive_dir / fs::PathFromString(BaseParams().DataDir()) / "blocks";
+    }
+    opts.blocks_archive_depth = args.GetIntArg("-blocksarchivedepth", opts.blocks_archive_depth);
+    if (opts.blocks_archive_depth < int{MIN_BLOCKS_TO_KEEP}) {
+        return util::Error{strprintf(_("-blocksarchivedepth must be at least %d."), MIN_BLOCKS_TO_KEEP)};
+    }
+
     return {};
 }
 } // namespace node
@@ -31,6 +31,7 @@
 #include <util/batchpriority.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
@@ -699,7 +700,11 @@ bool BlockManager::UndoWriteToDisk(const CBlockUndo& blockundo, FlatFilePos& pos
 bool BlockManager::UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& index) const
 {
     const FlatFilePos pos{WITH_LOCK(::cs_main, return index.GetUndoPos())};
+    return UndoReadFromDisk(blockundo, pos, index.pprev->GetBlockHash());
+}
 
+bool BlockManager::UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash) const
+{
     // Open history file to read
     AutoFile filein{OpenUndoFile(pos, true)};
     if (filein.IsNull()) {
@@ -711,7 +716,7 @@ bool BlockManager::UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& in
     uint256 hashChecksum;
     HashVerifier verifier{filein}; // Use HashVerifier as reserializing may lose data, c.f. commit d342424301013ec47dc146a4beb49d5c9319d80a
     try {
-        verifier << index.pprev->GetBlockHash();
+        verifier << prev_hash;
         verifier >> blockundo;
         filein >> hashChecksum;
     } catch (const std::exception& e) {
@@ -731,7 +736,7 @@ bool BlockManager::UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& in
 bool BlockManager::FlushUndoFile(int block_file, bool finalize)
 {
     FlatFilePos undo_pos_old(block_file, m_blockfile_info[block_file].nUndoSize);
-    if (!m_undo_file_seq.Flush(undo_pos_old, finalize)) {
+    if (!UndoFileSeq(undo_pos_old).Flush(undo_pos_old, finalize)) {
         m_opts.notifications.flushError(_("Flushing undo file to disk failed. This is likely the result of an I/O error."));
         return false;
     }
@@ -753,7 +758,7 @@ bool BlockManager::FlushBlockFile(int blockfile_num, bool fFinalize, bool finali
     assert(static_cast<int>(m_blockfile_info.size()) > blockfile_num);
 
     FlatFilePos block_pos_old(blockfile_num, m_blockfile_info[blockfile_num].nSize);
-    if (!m_block_file_seq.Flush(block_pos_old, fFinalize)) {
+    if (!BlockFileSeq(block_pos_old).Flush(block_pos_old, fFinalize)) {
         m_opts.notifications.flushError(_("Flushing block file to disk failed. This is likely the result of an I/O error."));
         success = false;
     }
@@ -813,20 +818,168 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     }
 }
 
+/**
+ * Open a file of the sequence, or of its archive if the file was moved there. Readers need not hold
+ * cs_main, so the file may be archived while we open it. It is removed from seq only once it is in
+ * the archive, so if opening it fails, look in the archive again.
+ */
+static FILE* OpenArchivedOr(const FlatFileSeq& seq, const std::optional<FlatFileSeq>& archive_seq, const FlatFilePos& pos, bool read_only)
+{
+    if (!archive_seq) return seq.Open(pos, read_only);
+    if (fs::exists(archive_seq->FileName(pos))) return archive_seq->Open(pos, read_only);
+    FILE* file{seq.Open(pos, read_only)};
+    if (!file && fs::exists(archive_seq->FileName(pos))) file = archive_seq->Open(pos, read_only);
+    return file;
+}
+
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
-    return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_xor_key};
+    return AutoFile{OpenArchivedOr(m_block_file_seq, m_archive_block_file_seq, pos, fReadOnly), m_xor_key};
 }
 
 /** Open an undo file (rev?????.dat) */
 AutoFile BlockManager::OpenUndoFile(const FlatFilePos& pos, bool fReadOnly) const
 {
-    return AutoFile{m_undo_file_seq.Open(pos, fReadOnly), m_xor_key};
+    return AutoFile{OpenArchivedOr(m_undo_file_seq, m_archive_undo_file_seq, pos, fReadOnly), m_xor_key};
 }
 
 fs::path BlockManager::GetBlockPosFilename(const FlatFilePos& pos) const
 {
-    return m_block_file_seq.FileName(pos);
+    return BlockFileSeq(pos).FileName(pos);
+}
+
+const FlatFileSeq& BlockManager::BlockFileSeq(const FlatFilePos& pos) const
+{
+    if (m_archive_block_file_seq && fs::exists(m_archive_block_file_seq->FileName(pos))) return *m_archive_block_file_seq;
+    return m_block_file_seq;
+}
+
+const FlatFileSeq& BlockManager::UndoFileSeq(const FlatFilePos& pos) const
+{
+    if (m_archive_undo_file_seq && fs::exists(m_archive_undo_file_seq->FileName(pos))) return *m_archive_undo_file_seq;
+    return m_undo_file_seq;
+}
+
+/**
+ * Append up to max_size bytes of src, from offset on, to dest.
+ * @returns the number of bytes copied, which is less than max_size once the end of src is reached
+ */
+static std::optional<uint64_t> CopyFileChunk(const fs::path& src, const fs::path& dest, uint64_t offset, uint64_t max_size)
+{
+    AutoFile in{fsbridge::fopen(src, "rb")};
+    AutoFile out{fsbridge::fopen(dest, offset == 0 ? "wb" : "ab")};
+    if (in.IsNull() || out.IsNull()) return std::nullopt;
+    std::vector<std::byte> buf(1 << 20);
+    uint64_t copied{0};
+    try {
+        in.seek(offset, SEEK_SET);
+        while (copied < max_size) {
+            const size_t read{in.detail_fread(Span{buf}.first(std::min<uint64_t>(buf.size(), max_size - copied)))};
+            if (read == 0) break;
+            out.write(Span{buf}.first(read));
+            copied += read;
+        }
+    } catch (const std::ios_base::failure&) {
+        return std::nullopt;
+    }
+    if (!out.Commit() || out.fclose() != 0) return std::nullopt;
+    return copied;
+}
+
+bool BlockManager::ArchiveBlockFile(int tip_height)
+{
+    if (!m_archive_block_file_seq || m_importing || !m_blockfiles_indexed) return false;
+    LOCK(m_archive_mutex);
+
+    const auto is_archivable{[&](int file_num) EXCLUSIVE_LOCKS_REQUIRED(cs_LastBlockFile) {
+        for (const auto& cursor : m_blockfile_cursors) {
+            if (cursor && cursor->file_num == file_num) return false;
+        }
+        const CBlockFileInfo& info{m_blockfile_info[file_num]};
+        return info.nSize > 0 && static_cast<int>(info.nHeightLast) + m_opts.blocks_archive_depth <= tip_height;
+    }};
+
+    if (!m_archive_copy) {
+        LOCK(cs_LastBlockFile);
+        bool all_archived{true};
+        for (int file_num = m_archive_scan_start; file_num < static_cast<int>(m_blockfile_info.size()); ++file_num) {
+            if (!is_archivable(file_num)) {
+                all_archived = false;
+            } else if (!fs::exists(m_archive_block_file_seq->FileName(FlatFilePos(file_num, 0)))) {
+                m_archive_copy.emplace(ArchiveCopy{.file_num = file_num});
+                break;
+            } else if (all_archived) {
+                m_archive_scan_start = file_num + 1;
+            }
+        }
+        if (!m_archive_copy) return false;
+    }
+    const FlatFilePos pos(m_archive_copy->file_num, 0);
+    const auto tmp_name{[](const FlatFileSeq& archive_seq, const FlatFilePos& file_pos) {
+        fs::path tmp{archive_seq.FileName(file_pos)};
+        tmp += ".tmp";
+        return tmp;
+    }};
+    const auto abort{[&]() EXCLUSIVE_LOCKS_REQUIRED(m_archive_mutex) {
+        std::error_code ec;
+        fs::remove(tmp_name(*m_archive_undo_file_seq, pos), ec);
+        fs::remove(tmp_name(*m_archive_block_file_seq, pos), ec);
+        m_archive_copy.reset();
+        return false;
+    }};
+
+    // Copy the undo file first, so that it is never left behind once the block
+    // file has been moved.
+    uint64_t budget{BLOCKS_ARCHIVE_CHUNK_SIZE};
+    while (budget > 0) {
+        const auto& [seq, archive_seq]{m_archive_copy->undo_done ? std::pair{&m_block_file_seq, &*m_archive_block_file_seq} :
+                                                                  std::pair{&m_undo_file_seq, &*m_archive_undo_file_seq}};
+        const fs::path src{seq->FileName(pos)};
+        const fs::path tmp{tmp_name(*archive_seq, pos)};
+        uint64_t copied{0};
+        if (fs::exists(src)) {
+            try {
+                fs::create_directories(tmp.parent_path());
+            } catch (const fs::filesystem_error& e) {
+                LogError("%s: failed to create %s: %s\n", __func__, fs::PathToString(tmp.parent_path()), fsbridge::get_filesystem_error_message(e));
+                return abort();
+            }
+            const auto chunk{CopyFileChunk(src, tmp, m_archive_copy->offset, budget)};
+            if (!chunk) {
+                LogError("%s: failed to copy %s to %s\n", __func__, fs::PathToString(src), fs::PathToString(tmp));
+                return abort();
+            }
+            copied = *chunk;
+        } else if (m_archive_copy->offset == 0) {
+            std::error_code ec;
+            fs::remove(tmp, ec);
+        }
+        budget -= copied;
+        m_archive_copy->offset += copied;
+        // The rest of the file is copied on the next call.
+        if (budget == 0) return false;
+        if (m_archive_copy->undo_done) break;
+        m_archive_copy->undo_done = true;
+        m_archive_copy->offset = 0;
+    }
+
+    // Block and undo data are only written under cs_main, so nothing can
+    // change the files while they are swapped.
+    LOCK(::cs_main);
+    if (!WITH_LOCK(cs_LastBlockFile, return is_archivable(pos.nFile))) return abort();
+    for (const FlatFileSeq* archive_seq : {&*m_archive_undo_file_seq, &*m_archive_block_file_seq}) {
+        const fs::path tmp{tmp_name(*archive_seq, pos)};
+        if (fs::exists(tmp) && !RenameOver(tmp, archive_seq->FileName(pos))) {
+            LogError("%s: failed to move %s to %s\n", __func__, fs::PathToString(tmp), fs::PathToString(archive_seq->FileName(pos)));
+            return abort();
+        }
+    }
+    m_archive_copy.reset();
+    std::error_code ec;
+    fs::remove(m_block_file_seq.FileName(pos), ec);
+    fs::remove(m_undo_file_seq.FileName(pos), ec);
+    LogPrintf("Archived blk/rev (%05u) to %s\n", pos.nFile, fs::PathToString(m_opts.blocks_archive_dir));
+    return true;
 }
 
 FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int nHeight, uint64_t nTime)
@@ -906,7 +1059,7 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
     m_blockfile_info[nFile].nSize += nAddSize;
 
     bool out_of_space;
-    size_t bytes_allocated = m_block_file_seq.Allocate(pos, nAddSize, out_of_space);
+    size_t bytes_allocated = BlockFileSeq(pos).Allocate(pos, nAddSize, out_of_space);
     if (out_of_space) {
         m_opts.notifications.fatalError(_("Disk space is too low!"));
         return {};
@@ -952,7 +1105,7 @@ bool BlockManager::FindUndoPos(BlockValidationState& state, int nFile, FlatFileP
     m_dirty_fileinfo.insert(nFile);
 
     bool out_of_space;
-    size_t bytes_allocated = m_undo_file_seq.Allocate(pos, nAddSize, out_of_space);
+    size_t bytes_allocated = UndoFileSeq(pos).Allocate(pos, nAddSize, out_of_space);
     if (out_of_space) {
         return FatalError(m_opts.notifications, state, _("Disk space is too low!"));
     }
@@ -1183,6 +1336,8 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
       m_opts{std::move(opts)},
       m_block_file_seq{FlatFileSeq{m_opts.blocks_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE}},
       m_undo_file_seq{FlatFileSeq{m_opts.blocks_dir, "rev", UNDOFILE_CHUNK_SIZE}},
+      m_archive_block_file_seq{m_opts.blocks_archive_dir.empty() ? std::nullopt : std::make_optional<FlatFileSeq>(m_opts.blocks_archive_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE)},
+      m_archive_undo_file_seq{m_opts.blocks_archive_dir.empty() ? std::nullopt : std::make_optional<FlatFileSeq>(m_opts.blocks_archive_dir, "rev", UNDOFILE_CHUNK_SIZE)},
       m_interrupt{interrupt} {}
 
 class ImportingNow
@@ -1208,26 +1363,10 @@ void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_
 
     // -reindex
     if (!chainman.m_blockman.m_blockfiles_indexed) {
-        int nFile = 0;
-        // Map of disk positions for blocks with unknown parent (only used for reindex);
-        // parent hash -> child disk position, multiple children can have the same parent.
-        std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
-        while (true) {
-            FlatFilePos pos(nFile, 0);
-            if (!fs::exists(chainman.m_blockman.GetBlockPosFilename(pos))) {
-                break; // No block files left to reindex
-            }
-            AutoFile file{chainman.m_blockman.OpenBlockFile(pos, true)};
-            if (file.IsNull()) {
-                break; // This error is logged in OpenBlockFile
-            }
-            LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-            chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
-            if (chainman.m_interrupt) {
-                LogPrintf("Interrupt requested. Exit %s\n", __func__);
-                return;
-            }
-            nFile++;
+        chainman.ReindexBlockFiles();
+        if (chainman.m_interrupt) {
+            LogPrintf("Interrupt requested. Exit %s\n", __func__);
+            return;
         }
         WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
         chainman.m_blockman.m_blockfiles_indexed = true;
@@ -22,6 +22,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -74,6 +75,11 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 
+/** How often to copy a chunk of a block file to the archive directory, see BlockManager::ArchiveBlockFile */
+static constexpr auto BLOCKS_ARCHIVE_INTERVAL{std::chrono::seconds{1}};
+/** How much of a block file to copy to the archive directory at a time */
+static constexpr uint64_t BLOCKS_ARCHIVE_CHUNK_SIZE{4 << 20}; // 4 MiB
+
 /** Size of header written by WriteBlockToDisk before a serialized CBlock */
 static constexpr size_t BLOCK_SERIALIZATION_HEADER_SIZE = std::tuple_size_v<MessageStartChars> + sizeof(unsigned int);
 
@@ -263,6 +269,25 @@ private:
 
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
+    //! The same files in the archive directory, if one is configured.
+    const std::optional<FlatFileSeq> m_archive_block_file_seq;
+    const std::optional<FlatFileSeq> m_archive_undo_file_seq;
+
+    //! Return the archive sequence if the given file has been archived, otherwise the regular one.
+    const FlatFileSeq& BlockFileSeq(const FlatFilePos& pos) const;
+    const FlatFileSeq& UndoFileSeq(const FlatFilePos& pos) const;
+
+    //! Progress of copying a blk/rev file pair to the archive directory.
+    struct ArchiveCopy {
+        int file_num;
+        //! Whether the undo file has been copied, and the block file is being copied.
+        bool undo_done{false};
+        uint64_t offset{0};
+    };
+    Mutex m_archive_mutex;
+    std::optional<ArchiveCopy> m_archive_copy GUARDED_BY(m_archive_mutex);
+    //! All files below this one are archived.
+    int m_archive_scan_start GUARDED_BY(m_archive_mutex){0};
 
 public:
     using Options = kernel::BlockManagerOpts;
@@ -420,12 +445,28 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
+    /**
+     * Move the oldest block file, and its undo file, whose blocks are all at
+     * least blocks_archive_depth below tip_height to the archive directory.
+     * They are copied without holding cs_main, BLOCKS_ARCHIVE_CHUNK_SIZE
+     * bytes per call so that the caller is not held up by slow storage, and
+     * then swapped in under cs_main. Reads find the files in either place.
+     * Does nothing if no archive directory is configured.
+     *
+     * @param[in] tip_height  Height of the lowest chainstate tip, so that no
+     *                        archived file still gets undo data written to it.
+     * @returns whether a file was archived
+     */
+    bool ArchiveBlockFile(int tip_height) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main, !m_archive_mutex);
+
     /** Functions for disk access for blocks */
     bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) const;
     bool ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) const;
     bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos) const;
 
     bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& index) const;
+    /** Read undo data at a known position. Does not need cs_main. */
+    bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash) const;
 
     void CleanupBlockRevFiles() const;
 };
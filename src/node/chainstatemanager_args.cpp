@@ -51,6 +51,7 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
 
     ReadDatabaseArgs(args, opts.block_tree_db);
     ReadDatabaseArgs(args, opts.coins_db);
+    if (auto value{args.GetIntArg("-dbmaxfilesize")}) opts.coins_db.max_file_size = std::clamp<int64_t>(*value, 1, 1024) << 20;
     ReadCoinsViewArgs(args, opts.coins_view);
 
     int script_threads = args.GetIntArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
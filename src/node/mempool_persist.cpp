@@ -4,11 +4,15 @@
 
 #include <node/mempool_persist.h>
 
+#include <checkqueue.h>
 #include <clientversion.h>
+#include <coins.h>
 #include <consensus/amount.h>
 #include <logging.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
+#include <script/interpreter.h>
 #include <serialize.h>
 #include <streams.h>
 #include <sync.h>
@@ -20,6 +24,8 @@
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
@@ -38,6 +44,71 @@ namespace node {
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
 
+/** Number of transactions read from the file before their scripts are pre-checked together and they
+ *  are submitted to the mempool one by one. */
+static constexpr size_t LOAD_BATCH_SIZE{1000};
+/** Maximum number of script checks pre-checked at once, which bounds how long cs_main and the
+ *  script check queue are held, and so how long a block being connected may wait for them. */
+static constexpr size_t PRECHECK_ROUND_SIZE{256};
+
+/**
+ * Verify the scripts of a batch of transactions about to be loaded on the script check threads, so
+ * that AcceptToMemoryPool finds their signatures in the signature cache rather than verifying each
+ * of them serially under cs_main. This only warms the cache: AcceptToMemoryPool still performs all
+ * checks itself, and transactions whose inputs cannot be found here are simply left to it.
+ */
+static void PrecheckScripts(CTxMemPool& pool, Chainstate& active_chainstate, const std::vector<std::pair<CTransactionRef, int64_t>>& batch)
+{
+    ChainstateManager& chainman{active_chainstate.m_chainman};
+    CCheckQueue<CScriptCheck>& queue{chainman.GetCheckQueue()};
+    if (!queue.HasThreads() || batch.empty()) return;
+
+    std::vector<PrecomputedTransactionData> txsdata(batch.size());
+    std::vector<CScriptCheck> checks;
+    {
+        LOCK2(cs_main, pool.cs);
+        CCoinsViewMemPool view{&active_chainstate.CoinsTip(), pool};
+        // Transactions are dumped with parents before their children, so outputs spent within the
+        // batch are found in the transactions preceding them.
+        std::map<Txid, const CTransaction*> batch_txs;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const CTransaction& tx{*batch[i].first};
+            std::vector<CTxOut> spent_outputs;
+            spent_outputs.reserve(tx.vin.size());
+            for (const CTxIn& txin : tx.vin) {
+                Coin coin;
+                if (view.GetCoin(txin.prevout, coin)) {
+                    spent_outputs.push_back(std::move(coin.out));
+                    continue;
+                }
+                const auto it{batch_txs.find(txin.prevout.hash)};
+                if (it == batch_txs.end() || txin.prevout.n >= it->second->vout.size()) break;
+                spent_outputs.push_back(it->second->vout[txin.prevout.n]);
+            }
+            batch_txs.emplace(tx.GetHash(), &tx);
+            if (tx.IsCoinBase() || spent_outputs.size() != tx.vin.size()) continue;
+
+            txsdata[i].Init(tx, std::move(spent_outputs));
+            for (unsigned int n = 0; n < tx.vin.size(); ++n) {
+                checks.emplace_back(txsdata[i].m_spent_outputs[n], tx, chainman.m_validation_cache.m_signature_cache,
+                                    n, STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txsdata[i]);
+            }
+        }
+    }
+
+    for (size_t begin{0}; begin < checks.size(); begin += PRECHECK_ROUND_SIZE) {
+        if (chainman.m_interrupt) return;
+        // Hold cs_main and then the queue for the round, as ConnectBlock does: a block being
+        // connected finishes first, and one that starts later waits for this round only. The
+        // control is destroyed before cs_main is released.
+        LOCK(cs_main);
+        CCheckQueueControl<CScriptCheck> control{&queue};
+        const auto end{checks.begin() + std::min(begin + PRECHECK_ROUND_SIZE, checks.size())};
+        control.Add({std::make_move_iterator(checks.begin() + begin), std::make_move_iterator(end)});
+        control.Wait();
+    }
+}
+
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
     if (load_path.empty()) return false;
@@ -72,31 +143,38 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
         int next_tenth_to_report = 0;
+        std::vector<std::pair<CTransactionRef, int64_t>> batch;
         while (txns_tried < total_txns_to_load) {
-            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
-            if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
-                next_tenth_to_report = percentage_done / 10;
-            }
-            ++txns_tried;
+            // Read the next batch of unexpired transactions.
+            batch.clear();
+            while (txns_tried < total_txns_to_load && batch.size() < LOAD_BATCH_SIZE) {
+                ++txns_tried;
 
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> TX_WITH_WITNESS(tx);
-            file >> nTime;
-            file >> nFeeDelta;
+                CTransactionRef tx;
+                int64_t nTime;
+                int64_t nFeeDelta;
+                file >> TX_WITH_WITNESS(tx);
+                file >> nTime;
+                file >> nFeeDelta;
 
-            if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
-            }
+                if (opts.use_current_time) {
+                    nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                }
 
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta && opts.apply_fee_delta_priority) {
+                    pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+                    batch.emplace_back(std::move(tx), nTime);
+                } else {
+                    ++expired;
+                }
             }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+
+            PrecheckScripts(pool, active_chainstate, batch);
+
+            for (const auto& [tx, nTime] : batch) {
                 LOCK(cs_main);
                 const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
                 if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
@@ -112,11 +190,16 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
                         ++failed;
                     }
                 }
-            } else {
-                ++expired;
+                if (active_chainstate.m_chainman.m_interrupt)
+                    return false;
+            }
+
+            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
+            if (next_tenth_to_report < percentage_done / 10) {
+                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
+                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                next_tenth_to_report = percentage_done / 10;
             }
-            if (active_chainstate.m_chainman.m_interrupt)
-                return false;
         }
         std::map<uint256, CAmount> mapDeltas;
         file >> mapDeltas;
@@ -5,10 +5,19 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
+#include <random.h>
 #include <util/check.h>
+#include <util/hasher.h>
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 
@@ -18,6 +27,45 @@ namespace {
 const std::string RECON_STATIC_SALT = "Tx Relay Salting";
 const HashWriter RECON_SALT_HASHER = TaggedHash(RECON_STATIC_SALT);
 
+/** Coefficient used to estimate the set difference for a reconciliation, see BIP-330. */
+constexpr double RECON_Q{0.25};
+/** The q coefficient is sent over the wire as an integer, scaled by Q_PRECISION. */
+constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/** False positive rate of sketch decoding is 1 in 2**RECON_FALSE_POSITIVE_COEF, see BIP-330. */
+constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+/** Each element of a sketch (a short ID) takes 4 bytes. */
+constexpr size_t BYTES_PER_SKETCH_CAPACITY{4};
+/** Maximum capacity of an initial sketch. Extensions double it. */
+constexpr size_t MAX_SKETCH_CAPACITY{2 << 12};
+/**
+ * Maximum number of transactions waiting in a reconciliation set. Beyond this, transactions are
+ * announced to the peer directly, which also bounds memory if a peer stops reconciling.
+ */
+constexpr size_t MAX_RECONSET_SIZE{3000};
+static_assert(MAX_RECONSET_SIZE <= std::numeric_limits<uint16_t>::max());
+
+/**
+ * Number of differences to decode from a sketch of the given capacity. Decoding fewer elements than
+ * the capacity allows is what keeps the false positive rate down to RECON_FALSE_POSITIVE_COEF.
+ */
+size_t MaxDecodedElements(size_t capacity)
+{
+    return Minisketch::ComputeMaxElements(32, capacity, RECON_FALSE_POSITIVE_COEF);
+}
+
+/** Progress of the reconciliation currently in flight with a peer. */
+enum class ReconciliationPhase {
+    NONE,
+    /** Initiator: request sent. Responder: request received, not answered yet. */
+    INIT_REQUESTED,
+    /** Responder: initial sketch sent. */
+    INIT_RESPONDED,
+    /** Initiator: sketch extension requested. */
+    EXT_REQUESTED,
+    /** Responder: sketch extension sent. */
+    EXT_RESPONDED,
+};
+
 /**
  * Salt (specified by BIP-330) constructed from contributions from both peers. It is used
  * to compute transaction short IDs, which are then used to construct a sketch representing a set
@@ -36,9 +84,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +92,110 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions to be reconciled in the next reconciliation round. */
+    std::unordered_set<Wtxid, SaltedTxidHasher> m_local_set;
+
+    /**
+     * Transactions being reconciled in the round in flight, by short ID. They are moved here from
+     * m_local_set when the round starts, so that transactions arriving meanwhile wait for the next.
+     */
+    std::unordered_map<uint32_t, Wtxid> m_snapshot;
+
+    ReconciliationPhase m_phase{ReconciliationPhase::NONE};
+
+    /** Initiator: when the reconciliation in flight was requested. */
+    std::chrono::microseconds m_request_time{0};
+
+    /** Responder: set size and q coefficient received in the pending request. */
+    uint16_t m_remote_set_size{0};
+    uint16_t m_remote_q{0};
+
+    /** Responder: capacity of the initial sketch we sent. */
+    size_t m_sketch_capacity{0};
+
+    /** Initiator: initial sketch received, kept until its extension arrives. */
+    std::vector<uint8_t> m_remote_sketch;
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Short ID of a transaction, as specified by BIP-330. */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + (s & 0xFFFFFFFF) % 0xFFFFFFFF;
+    }
+
+    /** Start a reconciliation round with the transactions currently in the set. */
+    void TakeSnapshot()
+    {
+        m_snapshot.clear();
+        for (const Wtxid& wtxid : m_local_set) m_snapshot.emplace(ComputeShortID(wtxid), wtxid);
+        m_local_set.clear();
+    }
+
+    /** Sketch of the snapshot with the given capacity. */
+    Minisketch ComputeSketch(size_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const auto& [short_id, _] : m_snapshot) sketch.Add(short_id);
+        return sketch;
+    }
+
+    /**
+     * Responder: capacity of the sketch to answer the pending request with, based on the estimated
+     * set difference |local - remote| + q * min(local, remote) + 1 (see BIP-330).
+     */
+    size_t EstimateSketchCapacity() const
+    {
+        const size_t local_set_size{m_snapshot.size()};
+        const size_t set_size_diff{local_set_size > m_remote_set_size ? local_set_size - m_remote_set_size : m_remote_set_size - local_set_size};
+        const double q{double(m_remote_q) / Q_PRECISION};
+        const size_t estimated_diff{set_size_diff + size_t(std::ceil(q * std::min<size_t>(local_set_size, m_remote_set_size))) + 1};
+        return std::min(Minisketch::ComputeCapacity(32, estimated_diff, RECON_FALSE_POSITIVE_COEF), MAX_SKETCH_CAPACITY);
+    }
+
+    /**
+     * Initiator: finish the round in flight, given the decoded set difference (or std::nullopt if
+     * the reconciliation failed, in which case the whole snapshot is announced).
+     */
+    SketchResult Conclude(const std::optional<std::vector<uint64_t>>& differences)
+    {
+        SketchResult result;
+        result.success = differences.has_value();
+        if (differences) {
+            std::unordered_set<uint32_t> missing;
+            for (const uint64_t short_id : *differences) {
+                const auto it{m_snapshot.find(uint32_t(short_id))};
+                if (it != m_snapshot.end()) {
+                    result.txs_to_announce.push_back(it->second);
+                } else {
+                    missing.insert(uint32_t(short_id));
+                }
+            }
+            // Transactions we received after taking the snapshot are not missing. The peer has
+            // them as well, so they need not be announced to it in the next round either.
+            if (!missing.empty()) {
+                for (auto it{m_local_set.begin()}; it != m_local_set.end();) {
+                    if (missing.erase(ComputeShortID(*it))) {
+                        it = m_local_set.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            result.txs_to_request.assign(missing.begin(), missing.end());
+        } else {
+            for (const auto& [_, wtxid] : m_snapshot) result.txs_to_announce.push_back(wtxid);
+        }
+        m_snapshot.clear();
+        m_remote_sketch.clear();
+        m_phase = ReconciliationPhase::NONE;
+        return result;
+    }
 };
 
 } // namespace
@@ -76,8 +217,27 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Registered peers we initiate reconciliations with, in the order we reconcile with them. */
+    std::deque<NodeId> m_queue GUARDED_BY(m_txreconciliation_mutex);
+
+    /** When the next reconciliation should be initiated, with the peer at the front of m_queue. */
+    std::chrono::microseconds m_next_recon_request GUARDED_BY(m_txreconciliation_mutex){0};
+
+    /** Randomizer for the choice of fanout targets. */
+    const CSipHasher m_fanout_randomizer;
+
+    TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto salt_or_state = m_states.find(peer_id);
+        if (salt_or_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&salt_or_state->second);
+    }
+
 public:
-    explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
+    explicit Impl(uint32_t recon_version)
+        : m_recon_version(recon_version),
+          m_fanout_randomizer{FastRandomContext().rand64(), FastRandomContext().rand64()} {}
 
     uint64_t PreRegisterPeer(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
     {
@@ -121,7 +281,8 @@ public:
                       peer_id, is_peer_inbound);
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
-        recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        recon_state->second.emplace<TxReconciliationState>(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        if (!is_peer_inbound) m_queue.push_back(peer_id);
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -129,6 +290,7 @@ public:
     {
         AssertLockNotHeld(m_txreconciliation_mutex);
         LOCK(m_txreconciliation_mutex);
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), peer_id), m_queue.end());
         if (m_states.erase(peer_id)) {
             LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Forget txreconciliation state of peer=%d\n", peer_id);
         }
@@ -142,6 +304,227 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || peer_state->m_local_set.size() >= MAX_RECONSET_SIZE) return false;
+        // A transaction already being reconciled must not be added again, or the peer would see
+        // it announced twice.
+        if (peer_state->m_snapshot.contains(peer_state->ComputeShortID(wtxid))) return true;
+        peer_state->m_local_set.insert(wtxid);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        return peer_state && peer_state->m_local_set.erase(wtxid) > 0;
+    }
+
+    std::vector<NodeId> GetFanoutTargets(const Wtxid& wtxid, size_t inbounds_flooding, size_t outbounds_flooding) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        // Rank the registered peers of each direction by a salted hash of the transaction and the
+        // peer, and pick the first ones.
+        std::vector<std::pair<uint64_t, NodeId>> inbounds, outbounds;
+        for (const auto& [peer_id, salt_or_state] : m_states) {
+            const auto* peer_state = std::get_if<TxReconciliationState>(&salt_or_state);
+            if (!peer_state) continue;
+            const uint64_t rank{CSipHasher(m_fanout_randomizer).Write(wtxid.ToUint256()).Write(peer_id).Finalize()};
+            (peer_state->m_we_initiate ? outbounds : inbounds).emplace_back(rank, peer_id);
+        }
+
+        const size_t outbound_targets{OUTBOUND_FANOUT_DESTINATIONS > outbounds_flooding ? OUTBOUND_FANOUT_DESTINATIONS - outbounds_flooding : 0};
+        // The number of inbound peers is rounded up or down at random, so that the fraction holds
+        // on average. Always rounding up would flood to every other peer of a node with just a few
+        // inbound peers.
+        const double inbound_fraction{(inbounds.size() + inbounds_flooding) * INBOUND_FANOUT_DESTINATIONS_FRACTION};
+        const double round_up{CSipHasher(m_fanout_randomizer).Write(wtxid.ToUint256()).Finalize() / std::pow(2.0, 64)};
+        const size_t inbound_total{size_t(inbound_fraction) + (round_up < inbound_fraction - std::floor(inbound_fraction))};
+        const size_t inbound_targets{inbound_total > inbounds_flooding ? inbound_total - inbounds_flooding : 0};
+
+        std::vector<NodeId> targets;
+        for (auto [peers, count] : {std::pair{&outbounds, outbound_targets}, std::pair{&inbounds, inbound_targets}}) {
+            count = std::min(count, peers->size());
+            std::partial_sort(peers->begin(), peers->begin() + count, peers->end());
+            for (size_t i = 0; i < count; ++i) targets.push_back((*peers)[i].second);
+        }
+        return targets;
+    }
+
+    std::optional<ReconciliationRequest> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || !peer_state->m_we_initiate) return std::nullopt;
+        if (m_queue.empty() || m_queue.front() != peer_id || now < m_next_recon_request) return std::nullopt;
+
+        // It is this peer's turn: move it to the back of the queue, and space requests so that
+        // every peer is reconciled with once per RECON_REQUEST_INTERVAL.
+        m_queue.pop_front();
+        m_queue.push_back(peer_id);
+        m_next_recon_request = now + std::chrono::microseconds{RECON_REQUEST_INTERVAL} / m_queue.size();
+
+        // Skip the turn if the previous reconciliation has not concluded yet.
+        if (peer_state->m_phase != ReconciliationPhase::NONE) return std::nullopt;
+
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Initiate reconciliation with peer=%d (set size %u)\n",
+                      peer_id, peer_state->m_local_set.size());
+        peer_state->m_phase = ReconciliationPhase::INIT_REQUESTED;
+        peer_state->m_request_time = now;
+        return ReconciliationRequest{
+            .set_size = uint16_t(peer_state->m_local_set.size()),
+            .q = uint16_t(RECON_Q * Q_PRECISION),
+        };
+    }
+
+    std::optional<std::vector<Wtxid>> ExpireReconciliation(NodeId peer_id, std::chrono::microseconds now)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || !peer_state->m_we_initiate || peer_state->m_phase == ReconciliationPhase::NONE) return std::nullopt;
+        if (now < peer_state->m_request_time + RECON_RESPONSE_TIMEOUT) return std::nullopt;
+
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d timed out, stop reconciling with it\n", peer_id);
+        std::vector<Wtxid> txs_to_announce{peer_state->m_local_set.begin(), peer_state->m_local_set.end()};
+        for (const auto& [_, wtxid] : peer_state->m_snapshot) txs_to_announce.push_back(wtxid);
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), peer_id), m_queue.end());
+        m_states.erase(peer_id);
+        return txs_to_announce;
+    }
+
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || peer_state->m_we_initiate) return false;
+        // The peer must wait for the previous reconciliation to conclude.
+        if (peer_state->m_phase != ReconciliationPhase::NONE) return false;
+
+        peer_state->m_remote_set_size = peer_set_size;
+        peer_state->m_remote_q = peer_q;
+        peer_state->m_phase = ReconciliationPhase::INIT_REQUESTED;
+        return true;
+    }
+
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || peer_state->m_we_initiate || peer_state->m_phase != ReconciliationPhase::INIT_REQUESTED) {
+            return std::nullopt;
+        }
+
+        peer_state->TakeSnapshot();
+        peer_state->m_sketch_capacity = peer_state->EstimateSketchCapacity();
+        peer_state->m_phase = ReconciliationPhase::INIT_RESPONDED;
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Respond to reconciliation request from peer=%d (set size %u, sketch capacity %u)\n",
+                      peer_id, peer_state->m_snapshot.size(), peer_state->m_sketch_capacity);
+        return peer_state->ComputeSketch(peer_state->m_sketch_capacity).Serialize();
+    }
+
+    std::optional<SketchResult> HandleSketch(NodeId peer_id, const std::vector<uint8_t>& skdata) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || !peer_state->m_we_initiate) return std::nullopt;
+        if (skdata.size() % BYTES_PER_SKETCH_CAPACITY != 0) return std::nullopt;
+
+        if (peer_state->m_phase == ReconciliationPhase::INIT_REQUESTED) {
+            const size_t capacity{skdata.size() / BYTES_PER_SKETCH_CAPACITY};
+            if (capacity > MAX_SKETCH_CAPACITY) return std::nullopt;
+            peer_state->TakeSnapshot();
+            // An empty sketch means the peer cannot reconcile: announce everything.
+            if (capacity == 0) return peer_state->Conclude(std::nullopt);
+
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(skdata);
+            auto differences{peer_state->ComputeSketch(capacity).Merge(remote_sketch).Decode(MaxDecodedElements(capacity))};
+            if (differences) return peer_state->Conclude(differences);
+
+            // The difference is larger than estimated. Ask for an extension.
+            peer_state->m_remote_sketch = skdata;
+            peer_state->m_phase = ReconciliationPhase::EXT_REQUESTED;
+            SketchResult result;
+            result.request_extension = true;
+            return result;
+        }
+
+        if (peer_state->m_phase == ReconciliationPhase::EXT_REQUESTED) {
+            if (skdata.size() != peer_state->m_remote_sketch.size()) return std::nullopt;
+            // The extension holds the syndromes following those of the initial sketch.
+            std::vector<uint8_t> full_skdata{std::move(peer_state->m_remote_sketch)};
+            full_skdata.insert(full_skdata.end(), skdata.begin(), skdata.end());
+            const size_t capacity{full_skdata.size() / BYTES_PER_SKETCH_CAPACITY};
+
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(full_skdata);
+            auto differences{peer_state->ComputeSketch(capacity).Merge(remote_sketch).Decode(MaxDecodedElements(capacity))};
+            if (!differences) {
+                LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d failed\n", peer_id);
+            }
+            return peer_state->Conclude(differences);
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::vector<uint8_t>> HandleSketchExtensionRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || peer_state->m_we_initiate || peer_state->m_phase != ReconciliationPhase::INIT_RESPONDED) {
+            return std::nullopt;
+        }
+
+        // The first half of the extended sketch is the initial sketch, which the peer already has.
+        const size_t capacity{peer_state->m_sketch_capacity};
+        std::vector<uint8_t> skdata{peer_state->ComputeSketch(capacity * 2).Serialize()};
+        skdata.erase(skdata.begin(), skdata.begin() + capacity * BYTES_PER_SKETCH_CAPACITY);
+        peer_state->m_phase = ReconciliationPhase::EXT_RESPONDED;
+        return skdata;
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, const std::vector<uint32_t>& ask_shortids)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state = GetRegisteredPeerState(peer_id);
+        if (!peer_state || peer_state->m_we_initiate) return std::nullopt;
+        if (peer_state->m_phase != ReconciliationPhase::INIT_RESPONDED && peer_state->m_phase != ReconciliationPhase::EXT_RESPONDED) {
+            return std::nullopt;
+        }
+
+        std::vector<Wtxid> txs_to_announce;
+        if (success) {
+            for (const uint32_t short_id : ask_shortids) {
+                const auto it{peer_state->m_snapshot.find(short_id)};
+                if (it != peer_state->m_snapshot.end()) txs_to_announce.push_back(it->second);
+            }
+        } else {
+            for (const auto& [_, wtxid] : peer_state->m_snapshot) txs_to_announce.push_back(wtxid);
+        }
+        peer_state->m_snapshot.clear();
+        peer_state->m_phase = ReconciliationPhase::NONE;
+        return txs_to_announce;
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +551,54 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+std::vector<NodeId> TxReconciliationTracker::GetFanoutTargets(const Wtxid& wtxid, size_t inbounds_flooding, size_t outbounds_flooding) const
+{
+    return m_impl->GetFanoutTargets(wtxid, inbounds_flooding, outbounds_flooding);
+}
+
+std::optional<ReconciliationRequest> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::ExpireReconciliation(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->ExpireReconciliation(peer_id, now);
+}
+
+bool TxReconciliationTracker::HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_set_size, peer_q);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::RespondToReconciliationRequest(NodeId peer_id)
+{
+    return m_impl->RespondToReconciliationRequest(peer_id);
+}
+
+std::optional<SketchResult> TxReconciliationTracker::HandleSketch(NodeId peer_id, const std::vector<uint8_t>& skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::HandleSketchExtensionRequest(NodeId peer_id)
+{
+    return m_impl->HandleSketchExtensionRequest(peer_id);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconciliationDifference(NodeId peer_id, bool success,
+                                                                                         const std::vector<uint32_t>& ask_shortids)
+{
+    return m_impl->HandleReconciliationDifference(peer_id, success, ask_shortids);
+}
@@ -7,13 +7,37 @@
 
 #include <net.h>
 #include <sync.h>
+#include <util/transaction_identifier.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <tuple>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
 
+/**
+ * Interval between initiating reconciliations with peers. Every RECON_REQUEST_INTERVAL, we
+ * reconcile with every outbound peer we reconcile with, one peer at a time and evenly spaced.
+ */
+static constexpr std::chrono::seconds RECON_REQUEST_INTERVAL{8s};
+
+/**
+ * How long an outbound peer has to conclude a reconciliation we initiated. Past that, we stop
+ * reconciling with it and announce the transactions in its set instead. This also covers peers
+ * which signal support for reconciliation in the handshake but never answer reqrecon.
+ */
+static constexpr std::chrono::seconds RECON_RESPONSE_TIMEOUT{30s};
+
+/** Number of outbound peers (not counting those we flood to anyway) a new transaction is flooded to. */
+static constexpr size_t OUTBOUND_FANOUT_DESTINATIONS{1};
+
+/** Fraction of inbound peers (counting those we flood to anyway) a new transaction is flooded to. */
+static constexpr double INBOUND_FANOUT_DESTINATIONS_FRACTION{0.1};
+
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
     SUCCESS,
@@ -21,6 +45,26 @@ enum class ReconciliationRegisterResult {
     PROTOCOL_VIOLATION,
 };
 
+/** A reconciliation request to send to a peer, see InitiateReconciliationRequest. */
+struct ReconciliationRequest {
+    /** Size of our reconciliation set for the peer. */
+    uint16_t set_size;
+    /** Coefficient used by the peer to estimate the set difference, scaled by Q_PRECISION. */
+    uint16_t q;
+};
+
+/** Outcome of handling a sketch received from a peer, see HandleSketch. */
+struct SketchResult {
+    /** Whether a sketch extension should be requested before the reconciliation can conclude. */
+    bool request_extension{false};
+    /** Whether the set difference was found. Sent back to the peer with txs_to_request. */
+    bool success{false};
+    /** Short IDs of the transactions we are missing, to be requested from the peer. */
+    std::vector<uint32_t> txs_to_request;
+    /** Transactions the peer is missing, to be announced to it. */
+    std::vector<Wtxid> txs_to_announce;
+};
+
 /**
  * Transaction reconciliation is a way for nodes to efficiently announce transactions.
  * This object keeps track of all txreconciliation-related communications with the peers.
@@ -47,6 +91,10 @@ enum class ReconciliationRegisterResult {
  * This is a modification of the Erlay protocol (https://arxiv.org/abs/1905.10518) with two
  * changes (sketch extensions instead of bisections, and an extra INV exchange round), both
  * are motivated in BIP-330.
+ *
+ * We initiate reconciliations with our outbound peers and respond to those initiated by our inbound
+ * peers. To keep transactions propagating quickly, each new transaction is still flooded to a few
+ * peers (see GetFanoutTargets) and only added to the reconciliation sets of the others.
  */
 class TxReconciliationTracker
 {
@@ -84,6 +132,73 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a transaction to the set of transactions to be reconciled with the peer, instead
+     * of announcing it. Returns false if the peer is not registered or its set is full, in which
+     * case the transaction should be announced to the peer directly.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the reconciliation set of the peer, e.g. because the peer
+     * announced it to us. Returns whether it was there.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Select the registered peers a new transaction should be flooded to rather than reconciled.
+     * The selection is random but deterministic for a given transaction. Peers which do not support
+     * reconciliation always have transactions flooded to them, so they count towards the targets
+     * (inbounds_flooding and outbounds_flooding are their numbers).
+     */
+    std::vector<NodeId> GetFanoutTargets(const Wtxid& wtxid, size_t inbounds_flooding, size_t outbounds_flooding) const;
+
+    /**
+     * Step 2. If it is our turn to reconcile with the outbound peer at time now, and no
+     * reconciliation with it is in progress, start one and return the request to send.
+     */
+    std::optional<ReconciliationRequest> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. If the outbound peer has not concluded the reconciliation we initiated within
+     * RECON_RESPONSE_TIMEOUT, stop reconciling with it and return the transactions in its set, to
+     * be announced to it instead.
+     */
+    std::optional<std::vector<Wtxid>> ExpireReconciliation(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. Record a reconciliation request received from an inbound peer, to be answered by
+     * RespondToReconciliationRequest. Returns false on a protocol violation.
+     */
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_set_size, uint16_t peer_q);
+
+    /**
+     * Step 2. If a reconciliation request from the peer is pending, return the sketch of our set
+     * to answer it with. The transactions in the set are held back until the reconciliation
+     * concludes, and new transactions go to the next round.
+     */
+    std::optional<std::vector<uint8_t>> RespondToReconciliationRequest(NodeId peer_id);
+
+    /**
+     * Steps 3 and 4. Combine a sketch (or sketch extension) received from an outbound peer with
+     * our own set. Returns std::nullopt on a protocol violation.
+     */
+    std::optional<SketchResult> HandleSketch(NodeId peer_id, const std::vector<uint8_t>& skdata);
+
+    /**
+     * Step 4b. Return the extension of the sketch we sent to the peer, which requested it after
+     * failing to decode the initial sketch. Returns std::nullopt on a protocol violation.
+     */
+    std::optional<std::vector<uint8_t>> HandleSketchExtensionRequest(NodeId peer_id);
+
+    /**
+     * Conclude a reconciliation initiated by the peer, which found the set difference (success)
+     * and asked for the transactions with the given short IDs, or failed. Returns the transactions
+     * to announce to the peer, or std::nullopt on a protocol violation.
+     */
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success,
+                                                                     const std::vector<uint32_t>& ask_shortids);
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
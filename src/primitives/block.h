@@ -34,7 +34,7 @@ public:
         SetNull();
     }
 
-    SERIALIZE_METHODS(CBlockHeader, obj) { READWRITE(obj.nVersion, obj.hashPrevBlock, obj.hashMerkleRoot, obj.nTime, obj.nBits, obj.nNonce); }
+    SERIALIZE_METHODS_FIXED_SIZE(CBlockHeader, obj, 80) { READWRITE(obj.nVersion, obj.hashPrevBlock, obj.hashMerkleRoot, obj.nTime, obj.nBits, obj.nNonce); }
 
     void SetNull()
     {
@@ -65,6 +65,25 @@ public:
 };
 
 
+/** Formatter for the transactions of a block, which are deserialized first and then hashed
+ *  together by MakeTransactionRefs. */
+struct BlockTransactionsFormatter
+{
+    template <typename Stream>
+    void Ser(Stream& s, const std::vector<CTransactionRef>& vtx)
+    {
+        s << vtx;
+    }
+
+    template <typename Stream>
+    void Unser(Stream& s, std::vector<CTransactionRef>& vtx)
+    {
+        std::vector<CMutableTransaction> txs;
+        s >> txs;
+        vtx = MakeTransactionRefs(std::move(txs));
+    }
+};
+
 class CBlock : public CBlockHeader
 {
 public:
@@ -89,7 +108,7 @@ public:
 
     SERIALIZE_METHODS(CBlock, obj)
     {
-        READWRITE(AsBase<CBlockHeader>(obj), obj.vtx);
+        READWRITE(AsBase<CBlockHeader>(obj), Using<BlockTransactionsFormatter>(obj.vtx));
     }
 
     void SetNull()
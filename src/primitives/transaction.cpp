@@ -10,13 +10,17 @@
 #include <hash.h>
 #include <script/script.h>
 #include <serialize.h>
+#include <span.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <uint256.h>
 #include <util/transaction_identifier.h>
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 std::string COutPoint::ToString() const
 {
@@ -94,6 +98,47 @@ Wtxid CTransaction::ComputeWitnessHash() const
 
 CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
 CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{hashes.m_hash}, m_witness_hash{hashes.m_witness_hash} {}
+
+/** Serialized size after which MakeTransactionRefs hashes the transactions it has serialized so far. */
+static constexpr size_t MAKE_TRANSACTION_REFS_BATCH_SIZE{1 << 20};
+
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs)
+{
+    std::vector<CTransactionRef> ret;
+    ret.reserve(txs.size());
+    std::vector<unsigned char> data;
+    std::vector<Span<const unsigned char>> inputs;
+    // Serialize the transactions without and then with their witnesses, a batch of them at a
+    // time to bound the size of the buffer, and hash the whole batch.
+    for (size_t begin = 0, end = 0; begin < txs.size(); begin = end) {
+        data.clear();
+        std::vector<size_t> ends;
+        for (end = begin; end < txs.size() && data.size() < MAKE_TRANSACTION_REFS_BATCH_SIZE; ++end) {
+            VectorWriter{data, data.size(), TX_NO_WITNESS(txs[end])};
+            ends.push_back(data.size());
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (!txs[i].HasWitness()) continue;
+            VectorWriter{data, data.size(), TX_WITH_WITNESS(txs[i])};
+            ends.push_back(data.size());
+        }
+        inputs.clear();
+        for (size_t i = 0; i < ends.size(); ++i) {
+            const size_t input_begin{i ? ends[i - 1] : 0};
+            inputs.emplace_back(data.data() + input_begin, ends[i] - input_begin);
+        }
+        const std::vector<uint256> hashes{HashBatch(inputs)};
+
+        size_t witness_hash_pos{end - begin};
+        for (size_t i = begin; i < end; ++i) {
+            const uint256& hash{hashes[i - begin]};
+            const uint256& witness_hash{txs[i].HasWitness() ? hashes[witness_hash_pos++] : hash};
+            ret.push_back(std::make_shared<const CTransaction>(std::move(txs[i]), CTransaction::PrecomputedHashes{Txid::FromUint256(hash), Wtxid::FromUint256(witness_hash)}));
+        }
+    }
+    return ret;
+}
 
 CAmount CTransaction::GetValueOut() const
 {
@@ -36,7 +36,7 @@ public:
     COutPoint(): n(NULL_INDEX) { }
     COutPoint(const Txid& hashIn, uint32_t nIn): hash(hashIn), n(nIn) { }
 
-    SERIALIZE_METHODS(COutPoint, obj) { READWRITE(obj.hash, obj.n); }
+    SERIALIZE_METHODS_FIXED_SIZE(COutPoint, obj, 36) { READWRITE(obj.hash, obj.n); }
 
     void SetNull() { hash.SetNull(); n = NULL_INDEX; }
     bool IsNull() const { return (hash.IsNull() && n == NULL_INDEX); }
@@ -320,9 +320,24 @@ private:
     bool ComputeHasWitness() const;
 
 public:
+    /** The hashes of a transaction, computed by MakeTransactionRefs together with those of other
+     *  transactions. Only it can create these, so a CTransaction is never given hashes which are
+     *  not its own. */
+    class PrecomputedHashes
+    {
+        friend CTransaction;
+        friend std::vector<std::shared_ptr<const CTransaction>> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+
+        Txid m_hash;
+        Wtxid m_witness_hash;
+
+        PrecomputedHashes(const Txid& hash, const Wtxid& witness_hash) : m_hash{hash}, m_witness_hash{witness_hash} {}
+    };
+
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     explicit CTransaction(CMutableTransaction&& tx);
+    CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
@@ -423,6 +438,10 @@ struct CMutableTransaction
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/** Convert CMutableTransactions into CTransactions, computing the hashes of all of them together,
+ *  several at a time where the CPU allows it. */
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs);
+
 /** A generic txid reference (txid or wtxid). */
 class GenTxid
 {
@@ -264,6 +264,26 @@ inline constexpr const char* WTXIDRELAY{"wtxidrelay"};
  * txreconciliation, as described by BIP 330.
  */
 inline constexpr const char* SENDTXRCNCL{"sendtxrcncl"};
+/**
+ * Contains the size of the sender's reconciliation set and the q coefficient used to estimate the
+ * set difference. Requests a sketch of the receiver's reconciliation set, as described by BIP 330.
+ */
+inline constexpr const char* REQRECON{"reqrecon"};
+/**
+ * Contains a sketch of the sender's reconciliation set (or its extension), in reply to a
+ * reqrecon or reqsketchext message, as described by BIP 330.
+ */
+inline constexpr const char* SKETCH{"sketch"};
+/**
+ * Requests an extension of the sketch previously sent, after it failed to decode, as described by
+ * BIP 330.
+ */
+inline constexpr const char* REQSKETCHEXT{"reqsketchext"};
+/**
+ * Concludes a reconciliation. Contains whether it succeeded and the short IDs of the transactions
+ * the sender is missing, as described by BIP 330.
+ */
+inline constexpr const char* RECONCILDIFF{"reconcildiff"};
 }; // namespace NetMsgType
 
 /** All known message types (see above). Keep this in the same order as the list of messages above. */
@@ -303,6 +323,10 @@ inline const std::array ALL_NET_MESSAGE_TYPES{std::to_array<std::string>({
     NetMsgType::CFCHECKPT,
     NetMsgType::WTXIDRELAY,
     NetMsgType::SENDTXRCNCL,
+    NetMsgType::REQRECON,
+    NetMsgType::SKETCH,
+    NetMsgType::REQSKETCHEXT,
+    NetMsgType::RECONCILDIFF,
 })};
 
 /** nServices flags */
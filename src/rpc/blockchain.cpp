@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -46,7 +47,9 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/hasher.h>
 #include <util/strencodings.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -54,10 +57,14 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
+#include <unordered_set>
 
 using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
@@ -68,16 +75,13 @@ using node::NodeContext;
 using node::SnapshotMetadata;
 using util::MakeUnorderedList;
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
-PrepareUTXOSnapshot(
-    Chainstate& chainstate,
-    const std::function<void()>& interruption_point = {})
+std::tuple<std::unique_ptr<CCoinsViewCursor>, const CBlockIndex*>
+PrepareUTXOSnapshot(Chainstate& chainstate)
     EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
@@ -2092,34 +2096,102 @@ static RPCHelpMan getblockstats()
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+using ScriptNeedles = std::unordered_set<CScript, SaltedSipHasher>;
+
+//! Maximum number of threads used to scan the UTXO set.
+static constexpr int MAX_SCAN_THREADS{16};
+
+//! Progress and results of scanning one partition of the UTXO set.
+struct ScanPartition {
+    std::unique_ptr<CCoinsViewCursor> cursor;
+    //! Fraction of the partition scanned so far, in 1/65536 units of the txid space.
+    std::atomic<uint32_t> progress{0};
+    int64_t count{0};
+    bool success{false};
+    std::map<COutPoint, Coin> results;
+};
+
+//! Search one partition of the UTXO set for a given set of pubkey scripts
+void FindScriptPubKey(ScanPartition& partition, uint32_t partition_start, const std::atomic<bool>& should_abort, const ScriptNeedles& needles)
 {
-    scan_progress = 0;
-    count = 0;
+    CCoinsViewCursor* cursor{partition.cursor.get()};
     while (cursor->Valid()) {
         COutPoint key;
         Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
-        if (++count % 8192 == 0) {
-            interruption_point();
+        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return;
+        if (++partition.count % 8192 == 0) {
             if (should_abort) {
                 // allow to abort the scan via the abort reference
-                return false;
+                return;
             }
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
+        if (partition.count % 256 == 0) {
+            // update progress every 256 items
+            const uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
+            partition.progress = high - partition_start;
         }
         if (needles.count(coin.out.scriptPubKey)) {
-            out_results.emplace(key, coin);
+            partition.results.emplace(key, coin);
         }
         cursor->Next();
     }
-    scan_progress = 100;
-    return true;
+    partition.success = true;
+}
+
+/**
+ * Search for a given set of pubkey scripts, scanning each of the given
+ * cursors (as returned by CCoinsViewDB::PartitionedCursors) on its own
+ * thread. The calling thread reports progress and handles interruption.
+ */
+bool FindScriptPubKey(std::atomic<int>& scan_progress, std::atomic<bool>& should_abort, int64_t& count, std::vector<std::unique_ptr<CCoinsViewCursor>> cursors, const ScriptNeedles& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+{
+    scan_progress = 0;
+    count = 0;
+
+    const size_t num_partitions{cursors.size()};
+    std::vector<ScanPartition> partitions(num_partitions);
+    std::vector<std::thread> threads;
+    threads.reserve(num_partitions);
+
+    Mutex mutex;
+    std::condition_variable cv;
+    size_t num_done{0};
+
+    for (size_t i = 0; i < num_partitions; ++i) {
+        partitions[i].cursor = std::move(cursors[i]);
+        threads.emplace_back([&, i] {
+            util::ThreadRename(strprintf("scantxoutset.%i", i));
+            FindScriptPubKey(partitions[i], i * 0x10000 / num_partitions, should_abort, needles);
+            WITH_LOCK(mutex, ++num_done);
+            cv.notify_one();
+        });
+    }
+
+    try {
+        WAIT_LOCK(mutex, lock);
+        while (num_done < num_partitions) {
+            cv.wait_for(lock, std::chrono::milliseconds{100});
+            REVERSE_LOCK(lock);
+            interruption_point();
+            uint64_t progress{0};
+            for (const auto& partition : partitions) progress += partition.progress;
+            scan_progress = (int)(progress * 100.0 / 65536.0 + 0.5);
+        }
+    } catch (...) {
+        should_abort = true;
+        for (std::thread& thread : threads) thread.join();
+        throw;
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    bool success{true};
+    for (auto& partition : partitions) {
+        success &= partition.success;
+        count += partition.count;
+        out_results.merge(partition.results);
+    }
+    if (success) scan_progress = 100;
+    return success;
 }
 } // namespace
 
@@ -2278,7 +2350,7 @@ static RPCHelpMan scantxoutset()
             throw JSONRPCError(RPC_MISC_ERROR, "scanobjects argument is required for the start action");
         }
 
-        std::set<CScript> needles;
+        ScriptNeedles needles;
         std::map<CScript, std::string> descriptors;
         CAmount total_in = 0;
 
@@ -2299,7 +2371,7 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
         {
@@ -2307,10 +2379,10 @@ static RPCHelpMan scantxoutset()
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            cursors = active_chainstate.CoinsDB().PartitionedCursors(std::clamp(GetNumCores(), 1, MAX_SCAN_THREADS));
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, std::move(cursors), needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2824,7 +2896,6 @@ static RPCHelpMan dumptxoutset()
 
     Chainstate* chainstate;
     std::unique_ptr<CCoinsViewCursor> cursor;
-    CCoinsStats stats;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
         // to get a UTXO database cursor while the chain is pointing at the
@@ -2844,11 +2915,11 @@ static RPCHelpMan dumptxoutset()
             LogWarning("dumptxoutset failed to roll back to requested height, reverting to tip.\n");
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
         } else {
-            std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
+            std::tie(cursor, tip) = PrepareUTXOSnapshot(*chainstate);
         }
     }
 
-    UniValue result = WriteUTXOSnapshot(*chainstate, cursor.get(), &stats, tip, afile, path, temppath, node.rpc_interruption_point);
+    UniValue result = WriteUTXOSnapshot(*chainstate, cursor.get(), tip, afile, path, temppath, node.rpc_interruption_point);
     fs::rename(temppath, path);
 
     result.pushKV("path", path.utf8string());
@@ -2857,24 +2928,21 @@ static RPCHelpMan dumptxoutset()
     };
 }
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
-PrepareUTXOSnapshot(
-    Chainstate& chainstate,
-    const std::function<void()>& interruption_point)
+std::tuple<std::unique_ptr<CCoinsViewCursor>, const CBlockIndex*>
+PrepareUTXOSnapshot(Chainstate& chainstate)
 {
     std::unique_ptr<CCoinsViewCursor> pcursor;
-    std::optional<CCoinsStats> maybe_stats;
     const CBlockIndex* tip;
 
     {
         // We need to lock cs_main to ensure that the coinsdb isn't written to
-        // between (i) flushing coins cache to disk (coinsdb), (ii) getting stats
-        // based upon the coinsdb, and (iii) constructing a cursor to the
-        // coinsdb for use in WriteUTXOSnapshot.
+        // between (i) flushing coins cache to disk (coinsdb) and (ii)
+        // constructing a cursor to the coinsdb for use in WriteUTXOSnapshot.
         //
         // Cursors returned by leveldb iterate over snapshots, so the contents
         // of the pcursor will not be affected by simultaneous writes during
-        // use below this block.
+        // use below this block. This is also what allows the UTXO set hash to
+        // be computed while writing the snapshot, without holding cs_main.
         //
         // See discussion here:
         //   https://github.com/bitcoin/bitcoin/pull/15606#discussion_r274479369
@@ -2883,22 +2951,19 @@ PrepareUTXOSnapshot(
 
         chainstate.ForceFlushStateToDisk();
 
-        maybe_stats = GetUTXOStats(&chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, interruption_point);
-        if (!maybe_stats) {
+        pcursor = chainstate.CoinsDB().Cursor();
+        if (!pcursor) {
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
-
-        pcursor = chainstate.CoinsDB().Cursor();
-        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
+        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(pcursor->GetBestBlock()));
     }
 
-    return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
+    return {std::move(pcursor), tip};
 }
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
@@ -2909,7 +2974,9 @@ UniValue WriteUTXOSnapshot(
         tip->nHeight, tip->GetBlockHash().ToString(),
         fs::PathToString(path), fs::PathToString(temppath)));
 
-    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), maybe_stats->coins_count};
+    // The number of coins is not known until the whole set has been written,
+    // so write a placeholder count now and fill in the real one at the end.
+    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), /*coins_count=*/0};
 
     afile << metadata;
 
@@ -2920,6 +2987,12 @@ UniValue WriteUTXOSnapshot(
     size_t written_coins_count{0};
     std::vector<std::pair<uint32_t, Coin>> coins;
 
+    // The UTXO set hash is computed over the coins as they are written,
+    // rather than in a separate pass over the database. It commits to the
+    // coins ordered by outpoint, like kernel::ComputeUTXOStats does.
+    HashWriter hasher{};
+    std::vector<std::pair<uint32_t, Coin>> sorted_coins;
+
     // To reduce space the serialization format of the snapshot avoids
     // duplication of tx hashes. The code takes advantage of the guarantee by
     // leveldb that keys are lexicographically sorted.
@@ -2935,6 +3008,19 @@ UniValue WriteUTXOSnapshot(
             afile << coin;
             ++written_coins_count;
         }
+
+        // Output indexes are VARINT-encoded in database keys, which does not
+        // preserve their numeric order beyond 16511 outputs.
+        const auto by_index{[](const auto& a, const auto& b) { return a.first < b.first; }};
+        const auto* to_hash{&coins};
+        if (!std::is_sorted(coins.begin(), coins.end(), by_index)) {
+            sorted_coins = coins;
+            std::sort(sorted_coins.begin(), sorted_coins.end(), by_index);
+            to_hash = &sorted_coins;
+        }
+        for (const auto& [n, coin] : *to_hash) {
+            kernel::ApplyCoinHash(hasher, COutPoint{last_hash, n}, coin);
+        }
     };
 
     pcursor->GetKey(key);
@@ -2949,6 +3035,8 @@ UniValue WriteUTXOSnapshot(
                 coins.clear();
             }
             coins.emplace_back(key.n, coin);
+        } else {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
         pcursor->Next();
     }
@@ -2957,16 +3045,20 @@ UniValue WriteUTXOSnapshot(
         write_coins_to_file(afile, last_hash, coins, written_coins_count);
     }
 
-    CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
+    metadata.m_coins_count = written_coins_count;
+    afile.seek(0, SEEK_SET);
+    afile << metadata;
 
-    afile.fclose();
+    if (afile.fclose() != 0) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Failed to write UTXO snapshot to " + temppath.utf8string());
+    }
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("coins_written", written_coins_count);
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
     result.pushKV("path", path.utf8string());
-    result.pushKV("txoutset_hash", maybe_stats->hashSerialized.ToString());
+    result.pushKV("txoutset_hash", hasher.GetHash().ToString());
     result.pushKV("nchaintx", tip->m_chain_tx_count);
     return result;
 }
@@ -2978,8 +3070,8 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath)
 {
-    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
-    return WriteUTXOSnapshot(chainstate, cursor.get(), &stats, tip, afile, path, tmppath, node.rpc_interruption_point);
+    auto [cursor, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate))};
+    return WriteUTXOSnapshot(chainstate, cursor.get(), tip, afile, path, tmppath, node.rpc_interruption_point);
 }
 
 static RPCHelpMan loadtxoutset()
@@ -161,6 +161,9 @@ static RPCHelpMan getpeerinfo()
                     {
                         {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                     }},
+                    {RPCResult::Type::NUM, "inflight_limit", "The number of blocks we can currently ask from this peer at once, adapted to its download speed"},
+                    {RPCResult::Type::NUM, "block_download_rate", /*optional=*/true, "The rate in bytes per second at which this peer sends us the blocks we ask from it, if measured"},
+                    {RPCResult::Type::NUM, "block_download_latency", /*optional=*/true, "The average time in seconds between asking this peer for a block and receiving it, if measured"},
                     {RPCResult::Type::BOOL, "addr_relay_enabled", "Whether we participate in address relay with this peer"},
                     {RPCResult::Type::NUM, "addr_processed", "The total number of addresses processed, excluding those dropped due to rate limiting"},
                     {RPCResult::Type::NUM, "addr_rate_limited", "The total number of addresses dropped due to rate limiting"},
@@ -267,6 +270,13 @@ static RPCHelpMan getpeerinfo()
             heights.push_back(height);
         }
         obj.pushKV("inflight", std::move(heights));
+        obj.pushKV("inflight_limit", statestats.m_block_download.inflight_limit);
+        if (statestats.m_block_download.bytes_per_sec) {
+            obj.pushKV("block_download_rate", *statestats.m_block_download.bytes_per_sec);
+        }
+        if (statestats.m_block_download.latency) {
+            obj.pushKV("block_download_latency", Ticks<SecondsDouble>(*statestats.m_block_download.latency));
+        }
         obj.pushKV("addr_relay_enabled", statestats.m_addr_relay_enabled);
         obj.pushKV("addr_processed", statestats.m_addr_processed);
         obj.pushKV("addr_rate_limited", statestats.m_addr_rate_limited);
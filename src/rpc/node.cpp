@@ -16,6 +16,7 @@
 #include <interfaces/ipc.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
@@ -25,6 +26,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validation.h>
 
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
@@ -400,12 +402,56 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static RPCHelpMan compactdatabase()
+{
+    return RPCHelpMan{"compactdatabase",
+                "\nCompact one of the LevelDB databases of the node, rewriting its data without the entries that were overwritten or erased.\n"
+                "This can take a long time on a large database. Block validation waits for the compaction of the chainstate or the block index to finish.\n",
+                {
+                    {"database", RPCArg::Type::STR, RPCArg::Optional::NO, "\"chainstate\", \"blockindex\", or the name of an index as returned by getindexinfo."},
+                },
+                RPCResult{RPCResult::Type::NONE, "", ""},
+                RPCExamples{
+                    HelpExampleCli("compactdatabase", "chainstate")
+                  + HelpExampleRpc("compactdatabase", "\"txindex\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const auto database{self.Arg<std::string>("database")};
+
+    if (database == "chainstate" || database == "blockindex") {
+        ChainstateManager& chainman = EnsureAnyChainman(request.context);
+        LOCK(cs_main);
+        if (database == "chainstate") {
+            chainman.ActiveChainstate().CoinsDB().CompactFull();
+        } else {
+            chainman.m_blockman.m_block_tree_db->CompactFull();
+        }
+        return UniValue::VNULL;
+    }
+
+    BaseIndex* index{nullptr};
+    if (g_txindex && g_txindex->GetName() == database) index = g_txindex.get();
+    if (g_coin_stats_index && g_coin_stats_index->GetName() == database) index = g_coin_stats_index.get();
+    ForEachBlockFilterIndex([&](BlockFilterIndex& filter_index) {
+        if (filter_index.GetName() == database) index = &filter_index;
+    });
+    if (!index) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Unknown or disabled database: %s", database));
+    }
+    index->CompactDB();
+    return UniValue::VNULL;
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
         {"util", &getindexinfo},
+        {"control", &compactdatabase},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
         {"hidden", &echo},
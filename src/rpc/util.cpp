@@ -1366,17 +1366,23 @@ std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, Fl
         range.first = 0;
         range.second = 0;
     }
+    // Expand each descriptor over the whole range at once, which hashes the keys of all positions together.
+    const size_t range_size{static_cast<size_t>(range.second - range.first + 1)};
+    std::vector<std::vector<std::vector<CScript>>> desc_scripts(descs.size());
+    for (size_t d = 0; d < descs.size(); ++d) {
+        std::vector<FlatSigningProvider> out;
+        if (!descs[d]->ExpandRange(range.first, range_size, provider, desc_scripts[d], out)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
+        }
+        for (FlatSigningProvider& keys : out) provider.Merge(std::move(keys));
+    }
     std::vector<CScript> ret;
-    for (int i = range.first; i <= range.second; ++i) {
-        for (const auto& desc : descs) {
-            std::vector<CScript> scripts;
-            if (!desc->Expand(i, provider, scripts, provider)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
-            }
+    for (size_t i = 0; i < range_size; ++i) {
+        for (size_t d = 0; d < descs.size(); ++d) {
             if (expand_priv) {
-                desc->ExpandPrivate(/*pos=*/i, provider, /*out=*/provider);
+                descs[d]->ExpandPrivate(/*pos=*/static_cast<int>(range.first + i), provider, /*out=*/provider);
             }
-            std::move(scripts.begin(), scripts.end(), std::back_inserter(ret));
+            std::move(desc_scripts[d][i].begin(), desc_scripts[d][i].end(), std::back_inserter(ret));
         }
     }
     return ret;
@@ -574,6 +574,26 @@ public:
     }
 };
 
+/** Number of keys from which expansion computes their IDs with Hash160Batch(), which only runs
+ *  faster than separate GetID() calls when it can fill the 8-way RIPEMD-160 transform. */
+constexpr size_t MIN_KEYS_HASH160_BATCH{8};
+
+/** Compute the key IDs of the public keys derived by an expansion, together if there are enough. */
+std::vector<CKeyID> GetKeyIDs(Span<const std::pair<CPubKey, KeyOriginInfo>> entries)
+{
+    std::vector<CKeyID> key_ids;
+    key_ids.reserve(entries.size());
+    if (entries.size() < MIN_KEYS_HASH160_BATCH) {
+        for (const auto& entry : entries) key_ids.push_back(entry.first.GetID());
+        return key_ids;
+    }
+    std::vector<Span<const unsigned char>> pubkey_data;
+    pubkey_data.reserve(entries.size());
+    for (const auto& entry : entries) pubkey_data.emplace_back(entry.first);
+    for (const uint160& hash : Hash160Batch(pubkey_data)) key_ids.emplace_back(hash);
+    return key_ids;
+}
+
 /** Base class for all Descriptor implementations. */
 class DescriptorImpl : public Descriptor
 {
@@ -594,15 +614,16 @@ protected:
 
     /** A helper function to construct the scripts for this descriptor.
      *
-     *  This function is invoked once by ExpandHelper.
+     *  This function is invoked once by ExpandFromPubKeys.
      *
      *  @param pubkeys The evaluations of the m_pubkey_args field.
+     *  @param key_ids The key IDs of pubkeys (one for each pubkeys element).
      *  @param scripts The evaluations of m_subdescriptor_args (one for each m_subdescriptor_args element).
      *  @param out A FlatSigningProvider to put scripts or public keys in that are necessary to the solver.
      *             The origin info of the provided pubkeys is automatically added.
      *  @return A vector with scriptPubKeys for this descriptor.
      */
-    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, Span<const CScript> scripts, FlatSigningProvider& out) const = 0;
+    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, Span<const CKeyID> key_ids, Span<const CScript> scripts, FlatSigningProvider& out) const = 0;
 
 public:
     DescriptorImpl(std::vector<std::unique_ptr<PubkeyProvider>> pubkeys, const std::string& name) : m_pubkey_args(std::move(pubkeys)), m_name(name), m_subdescriptor_args() {}
@@ -704,35 +725,87 @@ public:
         return ret;
     }
 
+    /** Derive the public keys of this descriptor and of its subdescriptors at position pos, in the
+     *  order ExpandFromPubKeys consumes them. */
     // NOLINTNEXTLINE(misc-no-recursion)
-    bool ExpandHelper(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache) const
+    bool DerivePubKeys(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<std::pair<CPubKey, KeyOriginInfo>>& entries, DescriptorCache* write_cache) const
     {
-        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
-        entries.reserve(m_pubkey_args.size());
-
-        // Construct temporary data in `entries`, `subscripts`, and `subprovider` to avoid producing output in case of failure.
         for (const auto& p : m_pubkey_args) {
             entries.emplace_back();
             if (!p->GetPubKey(pos, arg, entries.back().first, entries.back().second, read_cache, write_cache)) return false;
         }
+        for (const auto& subarg : m_subdescriptor_args) {
+            if (!subarg->DerivePubKeys(pos, arg, read_cache, entries, write_cache)) return false;
+        }
+        return true;
+    }
+
+    /** Construct the scripts of this descriptor from the public keys derived by DerivePubKeys and
+     *  their key IDs, consuming them from the front of `entries` and `key_ids`. */
+    // NOLINTNEXTLINE(misc-no-recursion)
+    void ExpandFromPubKeys(Span<std::pair<CPubKey, KeyOriginInfo>>& entries, Span<const CKeyID>& key_ids, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const
+    {
+        const auto own_entries{entries.first(m_pubkey_args.size())};
+        const auto own_key_ids{key_ids.first(m_pubkey_args.size())};
+        entries = entries.subspan(m_pubkey_args.size());
+        key_ids = key_ids.subspan(m_pubkey_args.size());
+
         std::vector<CScript> subscripts;
         FlatSigningProvider subprovider;
         for (const auto& subarg : m_subdescriptor_args) {
             std::vector<CScript> outscripts;
-            if (!subarg->ExpandHelper(pos, arg, read_cache, outscripts, subprovider, write_cache)) return false;
+            subarg->ExpandFromPubKeys(entries, key_ids, outscripts, subprovider);
             assert(outscripts.size() == 1);
             subscripts.emplace_back(std::move(outscripts[0]));
         }
         out.Merge(std::move(subprovider));
 
         std::vector<CPubKey> pubkeys;
-        pubkeys.reserve(entries.size());
-        for (auto& entry : entries) {
-            pubkeys.push_back(entry.first);
-            out.origins.emplace(entry.first.GetID(), std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(entry.first), std::move(entry.second)));
+        pubkeys.reserve(own_entries.size());
+        for (size_t i = 0; i < own_entries.size(); ++i) {
+            pubkeys.push_back(own_entries[i].first);
+            out.origins.emplace(own_key_ids[i], std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(own_entries[i].first), std::move(own_entries[i].second)));
         }
 
-        output_scripts = MakeScripts(pubkeys, Span{subscripts}, out);
+        output_scripts = MakeScripts(pubkeys, own_key_ids, Span{subscripts}, out);
+    }
+
+    bool ExpandHelper(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache) const
+    {
+        // Construct temporary data in `entries` to avoid producing output in case of failure.
+        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
+        entries.reserve(m_pubkey_args.size());
+        if (!DerivePubKeys(pos, arg, read_cache, entries, write_cache)) return false;
+
+        // Multisig descriptors can have many keys, so hash them together.
+        const std::vector<CKeyID> key_ids{GetKeyIDs(entries)};
+        Span<std::pair<CPubKey, KeyOriginInfo>> entries_left{entries};
+        Span<const CKeyID> key_ids_left{key_ids};
+        ExpandFromPubKeys(entries_left, key_ids_left, output_scripts, out);
+        return true;
+    }
+
+    bool ExpandRangeHelper(int pos_begin, size_t count, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache) const
+    {
+        // Derive the keys of all positions first, so that their key IDs are hashed together even
+        // when each position has a single key.
+        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
+        std::vector<size_t> entries_end;
+        entries_end.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!DerivePubKeys(pos_begin + static_cast<int>(i), arg, read_cache, entries, write_cache)) return false;
+            entries_end.push_back(entries.size());
+        }
+
+        const std::vector<CKeyID> key_ids{GetKeyIDs(entries)};
+        Span<std::pair<CPubKey, KeyOriginInfo>> entries_left{entries};
+        Span<const CKeyID> key_ids_left{key_ids};
+        output_scripts.assign(entries_end.size(), {});
+        out.assign(entries_end.size(), {});
+        for (size_t i = 0; i < entries_end.size(); ++i) {
+            ExpandFromPubKeys(entries_left, key_ids_left, output_scripts[i], out[i]);
+            assert(entries.size() - entries_left.size() == entries_end[i]);
+        }
         return true;
     }
 
@@ -746,6 +819,16 @@ public:
         return ExpandHelper(pos, DUMMY_SIGNING_PROVIDER, &read_cache, output_scripts, out, nullptr);
     }
 
+    bool ExpandRange(int pos_begin, size_t count, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache = nullptr) const final
+    {
+        return ExpandRangeHelper(pos_begin, count, provider, nullptr, output_scripts, out, write_cache);
+    }
+
+    bool ExpandRangeFromCache(int pos_begin, size_t count, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const final
+    {
+        return ExpandRangeHelper(pos_begin, count, DUMMY_SIGNING_PROVIDER, &read_cache, output_scripts, out, nullptr);
+    }
+
     // NOLINTNEXTLINE(misc-no-recursion)
     void ExpandPrivate(int pos, const SigningProvider& provider, FlatSigningProvider& out) const final
     {
@@ -797,7 +880,7 @@ class AddressDescriptor final : public DescriptorImpl
     const CTxDestination m_destination;
 protected:
     std::string ToStringExtra() const override { return EncodeDestination(m_destination); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
 public:
     AddressDescriptor(CTxDestination destination) : DescriptorImpl({}, "addr"), m_destination(std::move(destination)) {}
     bool IsSolvable() const final { return false; }
@@ -822,7 +905,7 @@ class RawDescriptor final : public DescriptorImpl
     const CScript m_script;
 protected:
     std::string ToStringExtra() const override { return HexStr(m_script); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
 public:
     RawDescriptor(CScript script) : DescriptorImpl({}, "raw"), m_script(std::move(script)) {}
     bool IsSolvable() const final { return false; }
@@ -850,7 +933,7 @@ class PKDescriptor final : public DescriptorImpl
 private:
     const bool m_xonly;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override
     {
         if (m_xonly) {
             CScript script = CScript() << ToByteVector(XOnlyPubKey(keys[0])) << OP_CHECKSIG;
@@ -888,9 +971,9 @@ public:
 class PKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
-        CKeyID id = keys[0].GetID();
+        CKeyID id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         return Vector(GetScriptForDestination(PKHash(id)));
     }
@@ -922,9 +1005,9 @@ public:
 class WPKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
-        CKeyID id = keys[0].GetID();
+        CKeyID id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         return Vector(GetScriptForDestination(WitnessV0KeyHash(id)));
     }
@@ -956,10 +1039,10 @@ public:
 class ComboDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
         std::vector<CScript> ret;
-        CKeyID id = keys[0].GetID();
+        CKeyID id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         ret.emplace_back(GetScriptForRawPubKey(keys[0])); // P2PK
         ret.emplace_back(GetScriptForDestination(PKHash(id))); // P2PKH
@@ -987,7 +1070,7 @@ class MultisigDescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override {
         if (m_sorted) {
             std::vector<CPubKey> sorted_keys(keys);
             std::sort(sorted_keys.begin(), sorted_keys.end());
@@ -1033,7 +1116,7 @@ class MultiADescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override {
         CScript ret;
         std::vector<XOnlyPubKey> xkeys;
         xkeys.reserve(keys.size());
@@ -1076,7 +1159,7 @@ public:
 class SHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1126,7 +1209,7 @@ public:
 class WSHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(WitnessV0ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1168,7 +1251,7 @@ class TRDescriptor final : public DescriptorImpl
 {
     std::vector<int> m_depths;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         TaprootBuilder builder;
         assert(m_depths.size() == scripts.size());
@@ -1182,7 +1265,7 @@ protected:
         builder.Finalize(xpk);
         WitnessV1Taproot output = builder.GetOutput();
         out.tr_trees[output] = builder;
-        out.pubkeys.emplace(keys[0].GetID(), keys[0]);
+        out.pubkeys.emplace(key_ids[0], keys[0]);
         return Vector(GetScriptForDestination(output));
     }
     bool ToStringSubScriptHelper(const SigningProvider* arg, std::string& ret, const StringType type, const DescriptorCache* cache = nullptr) const override
@@ -1247,6 +1330,8 @@ public:
 class ScriptMaker {
     //! Keys contained in the Miniscript (the evaluation of DescriptorImpl::m_pubkey_args).
     const std::vector<CPubKey>& m_keys;
+    //! The key IDs of m_keys.
+    const Span<const CKeyID> m_key_ids;
     //! The script context we're operating within (Tapscript or P2WSH).
     const miniscript::MiniscriptContext m_script_ctx;
 
@@ -1257,11 +1342,11 @@ class ScriptMaker {
         if (miniscript::IsTapscript(m_script_ctx)) {
             return Hash160(XOnlyPubKey{m_keys[key]});
         }
-        return m_keys[key].GetID();
+        return m_key_ids[key];
     }
 
 public:
-    ScriptMaker(const std::vector<CPubKey>& keys LIFETIMEBOUND, const miniscript::MiniscriptContext script_ctx) : m_keys(keys), m_script_ctx{script_ctx} {}
+    ScriptMaker(const std::vector<CPubKey>& keys LIFETIMEBOUND, Span<const CKeyID> key_ids LIFETIMEBOUND, const miniscript::MiniscriptContext script_ctx) : m_keys(keys), m_key_ids(key_ids), m_script_ctx{script_ctx} {}
 
     std::vector<unsigned char> ToPKBytes(uint32_t key) const {
         // In Tapscript keys always serialize as x-only, whether an x-only key was used in the descriptor or not.
@@ -1311,18 +1396,18 @@ private:
     miniscript::NodeRef<uint32_t> m_node;
 
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts,
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript> scripts,
                                      FlatSigningProvider& provider) const override
     {
         const auto script_ctx{m_node->GetMsCtx()};
-        for (const auto& key : keys) {
+        for (size_t i = 0; i < keys.size(); ++i) {
             if (miniscript::IsTapscript(script_ctx)) {
-                provider.pubkeys.emplace(Hash160(XOnlyPubKey{key}), key);
+                provider.pubkeys.emplace(Hash160(XOnlyPubKey{keys[i]}), keys[i]);
             } else {
-                provider.pubkeys.emplace(key.GetID(), key);
+                provider.pubkeys.emplace(key_ids[i], keys[i]);
             }
         }
-        return Vector(m_node->ToScript(ScriptMaker(keys, script_ctx)));
+        return Vector(m_node->ToScript(ScriptMaker(keys, key_ids, script_ctx)));
     }
 
 public:
@@ -1368,7 +1453,7 @@ public:
 class RawTRDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         assert(keys.size() == 1);
         XOnlyPubKey xpk(keys[0]);
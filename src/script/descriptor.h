@@ -136,6 +136,30 @@ struct Descriptor {
      */
     virtual bool ExpandFromCache(int pos, const DescriptorCache& read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const = 0;
 
+    /** Expand a descriptor at every position of a range. This is equivalent to calling Expand() for
+     *  each position, but the key IDs of all positions are hashed together.
+     *
+     * @param[in] pos_begin The first position at which to expand the descriptor. If IsRange() is false, this is ignored.
+     * @param[in] count The number of consecutive positions at which to expand the descriptor.
+     * @param[in] provider The provider to query for private keys in case of hardened derivation.
+     * @param[out] output_scripts The expanded scriptPubKeys, for each position.
+     * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys, for each position.
+     * @param[out] write_cache Cache data necessary to evaluate the descriptor at these positions without access to private keys.
+     */
+    virtual bool ExpandRange(int pos_begin, size_t count, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache = nullptr) const = 0;
+
+    /** Expand a descriptor at every position of a range using cached expansion data. This is
+     *  equivalent to calling ExpandFromCache() for each position, but the key IDs of all positions
+     *  are hashed together.
+     *
+     * @param[in] pos_begin The first position at which to expand the descriptor. If IsRange() is false, this is ignored.
+     * @param[in] count The number of consecutive positions at which to expand the descriptor.
+     * @param[in] read_cache Cached expansion data.
+     * @param[out] output_scripts The expanded scriptPubKeys, for each position.
+     * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys, for each position.
+     */
+    virtual bool ExpandRangeFromCache(int pos_begin, size_t count, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const = 0;
+
     /** Expand the private key for a descriptor at a specified position, if possible.
      *
      * @param[in] pos The position at which to expand the descriptor. If IsRange() is false, this is ignored.
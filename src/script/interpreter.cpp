@@ -10,6 +10,7 @@
 #include <crypto/sha256.h>
 #include <pubkey.h>
 #include <script/script.h>
+#include <streams.h>
 #include <uint256.h>
 
 typedef std::vector<unsigned char> valtype;
@@ -706,10 +707,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 -- x1 x2 x1 x2)
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-2);
-                    valtype vch2 = stacktop(-1);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    stack.push_back(stacktop(-2));
+                    stack.push_back(stacktop(-2));
                 }
                 break;
 
@@ -718,12 +717,9 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 -- x1 x2 x3 x1 x2 x3)
                     if (stack.size() < 3)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-3);
-                    valtype vch2 = stacktop(-2);
-                    valtype vch3 = stacktop(-1);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
-                    stack.push_back(vch3);
+                    stack.push_back(stacktop(-3));
+                    stack.push_back(stacktop(-3));
+                    stack.push_back(stacktop(-3));
                 }
                 break;
 
@@ -732,10 +728,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 x4 -- x1 x2 x3 x4 x1 x2)
                     if (stack.size() < 4)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-4);
-                    valtype vch2 = stacktop(-3);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    stack.push_back(stacktop(-4));
+                    stack.push_back(stacktop(-4));
                 }
                 break;
 
@@ -744,11 +738,11 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 x4 x5 x6 -- x3 x4 x5 x6 x1 x2)
                     if (stack.size() < 6)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-6);
-                    valtype vch2 = stacktop(-5);
+                    valtype vch1 = std::move(stacktop(-6));
+                    valtype vch2 = std::move(stacktop(-5));
                     stack.erase(stack.end()-6, stack.end()-4);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    stack.push_back(std::move(vch1));
+                    stack.push_back(std::move(vch2));
                 }
                 break;
 
@@ -767,9 +761,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x - 0 | x x)
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-1);
-                    if (CastToBool(vch))
-                        stack.push_back(vch);
+                    if (CastToBool(stacktop(-1)))
+                        stack.push_back(stacktop(-1));
                 }
                 break;
 
@@ -795,8 +788,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x -- x x)
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-1);
-                    stack.push_back(vch);
+                    stack.push_back(stacktop(-1));
                 }
                 break;
 
@@ -814,8 +806,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 -- x1 x2 x1)
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-2);
-                    stack.push_back(vch);
+                    stack.push_back(stacktop(-2));
                 }
                 break;
 
@@ -830,10 +821,13 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     popstack(stack);
                     if (n < 0 || n >= (int)stack.size())
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-n-1);
-                    if (opcode == OP_ROLL)
+                    if (opcode == OP_ROLL) {
+                        valtype vch = std::move(stacktop(-n-1));
                         stack.erase(stack.end()-n-1);
-                    stack.push_back(vch);
+                        stack.push_back(std::move(vch));
+                    } else {
+                        stack.push_back(stacktop(-n-1));
+                    }
                 }
                 break;
 
@@ -864,7 +858,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
                     valtype vch = stacktop(-1);
-                    stack.insert(stack.end()-2, vch);
+                    stack.insert(stack.end()-2, std::move(vch));
                 }
                 break;
 
@@ -1371,27 +1365,18 @@ uint256 GetOutputsSHA256(const T& txTo)
     return ss.GetSHA256();
 }
 
-/** Compute the (single) SHA256 of the concatenation of all amounts spent by a tx. */
-uint256 GetSpentAmountsSHA256(const std::vector<CTxOut>& outputs_spent)
-{
-    HashWriter ss{};
-    for (const auto& txout : outputs_spent) {
-        ss << txout.nValue;
-    }
-    return ss.GetSHA256();
-}
-
-/** Compute the (single) SHA256 of the concatenation of all scriptPubKeys spent by a tx. */
-uint256 GetSpentScriptsSHA256(const std::vector<CTxOut>& outputs_spent)
+/** Serialize the concatenation of `get(item)` for all items, to be hashed. */
+template <typename Items, typename Get>
+std::vector<unsigned char> SerializeAll(const Items& items, Get get)
 {
-    HashWriter ss{};
-    for (const auto& txout : outputs_spent) {
-        ss << txout.scriptPubKey;
+    std::vector<unsigned char> ret;
+    VectorWriter writer{ret, 0};
+    for (const auto& item : items) {
+        writer << get(item);
     }
-    return ss.GetSHA256();
+    return ret;
 }
 
-
 } // namespace
 
 template <class T>
@@ -1427,11 +1412,25 @@ void PrecomputedTransactionData::Init(const T& txTo, std::vector<CTxOut>&& spent
         if (uses_bip341_taproot && uses_bip143_segwit) break; // No need to scan further if we already need all.
     }
 
+    // The single hashes are independent of each other, so they are computed together: the
+    // computations shared between both sighash schemes, then those specific to BIP341.
+    std::vector<std::vector<unsigned char>> preimages;
+    if (uses_bip143_segwit || uses_bip341_taproot) {
+        preimages.push_back(SerializeAll(txTo.vin, [](const CTxIn& txin) -> const COutPoint& { return txin.prevout; }));
+        preimages.push_back(SerializeAll(txTo.vin, [](const CTxIn& txin) { return txin.nSequence; }));
+        preimages.push_back(SerializeAll(txTo.vout, [](const CTxOut& txout) -> const CTxOut& { return txout; }));
+    }
+    const bool bip341_taproot_ready{uses_bip341_taproot && m_spent_outputs_ready};
+    if (bip341_taproot_ready) {
+        preimages.push_back(SerializeAll(m_spent_outputs, [](const CTxOut& txout) { return txout.nValue; }));
+        preimages.push_back(SerializeAll(m_spent_outputs, [](const CTxOut& txout) -> const CScript& { return txout.scriptPubKey; }));
+    }
+    const std::vector<uint256> single_hashes{SHA256Batch(std::vector<Span<const unsigned char>>(preimages.begin(), preimages.end()))};
+
     if (uses_bip143_segwit || uses_bip341_taproot) {
-        // Computations shared between both sighash schemes.
-        m_prevouts_single_hash = GetPrevoutsSHA256(txTo);
-        m_sequences_single_hash = GetSequencesSHA256(txTo);
-        m_outputs_single_hash = GetOutputsSHA256(txTo);
+        m_prevouts_single_hash = single_hashes[0];
+        m_sequences_single_hash = single_hashes[1];
+        m_outputs_single_hash = single_hashes[2];
     }
     if (uses_bip143_segwit) {
         hashPrevouts = SHA256Uint256(m_prevouts_single_hash);
@@ -1439,9 +1438,9 @@ void PrecomputedTransactionData::Init(const T& txTo, std::vector<CTxOut>&& spent
         hashOutputs = SHA256Uint256(m_outputs_single_hash);
         m_bip143_segwit_ready = true;
     }
-    if (uses_bip341_taproot && m_spent_outputs_ready) {
-        m_spent_amounts_single_hash = GetSpentAmountsSHA256(m_spent_outputs);
-        m_spent_scripts_single_hash = GetSpentScriptsSHA256(m_spent_outputs);
+    if (bip341_taproot_ready) {
+        m_spent_amounts_single_hash = single_hashes[3];
+        m_spent_scripts_single_hash = single_hashes[4];
         m_bip341_taproot_ready = true;
     }
 }
@@ -1825,6 +1824,38 @@ static bool ExecuteWitnessScript(const Span<const valtype>& stack_span, const CS
     return true;
 }
 
+/**
+ * Verify a P2WPKH spend directly, without running the interpreter on its
+ * implied OP_DUP OP_HASH160 <program> OP_EQUALVERIFY OP_CHECKSIG script.
+ * Gives the same result and error as ExecuteWitnessScript on that script.
+ */
+static bool ExecuteWitnessKeyHash(const Span<const valtype>& stack, const CScript& exec_script, const std::vector<unsigned char>& program, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror)
+{
+    assert(stack.size() == 2);
+    const valtype& sig = stack[0];
+    const valtype& pubkey = stack[1];
+
+    // Disallow stack item size > MAX_SCRIPT_ELEMENT_SIZE in witness stack
+    if (sig.size() > MAX_SCRIPT_ELEMENT_SIZE || pubkey.size() > MAX_SCRIPT_ELEMENT_SIZE) {
+        return set_error(serror, SCRIPT_ERR_PUSH_SIZE);
+    }
+
+    // OP_DUP OP_HASH160 <program> OP_EQUALVERIFY
+    uint160 pubkey_hash;
+    CHash160().Write(pubkey).Finalize(pubkey_hash);
+    if (memcmp(pubkey_hash.begin(), program.data(), WITNESS_V0_KEYHASH_SIZE)) {
+        return set_error(serror, SCRIPT_ERR_EQUALVERIFY);
+    }
+
+    // OP_CHECKSIG, which leaves its result as the only stack element
+    bool success = false;
+    if (!EvalChecksigPreTapscript(sig, pubkey, exec_script.begin(), exec_script.end(), flags, checker, SigVersion::WITNESS_V0, serror, success)) {
+        return false;
+    }
+    if (!success) return set_error(serror, SCRIPT_ERR_EVAL_FALSE);
+    return set_success(serror);
+}
+
 uint256 ComputeTapleafHash(uint8_t leaf_version, Span<const unsigned char> script)
 {
     return (HashWriter{HASHER_TAPLEAF} << leaf_version << CompactSizeWriter(script.size()) << script).GetSHA256();
@@ -1896,7 +1927,7 @@ static bool VerifyWitnessProgram(const CScriptWitness& witness, int witversion,
                 return set_error(serror, SCRIPT_ERR_WITNESS_PROGRAM_MISMATCH); // 2 items in witness
             }
             exec_script << OP_DUP << OP_HASH160 << program << OP_EQUALVERIFY << OP_CHECKSIG;
-            return ExecuteWitnessScript(stack, exec_script, flags, SigVersion::WITNESS_V0, checker, execdata, serror);
+            return ExecuteWitnessKeyHash(stack, exec_script, program, flags, checker, serror);
         } else {
             return set_error(serror, SCRIPT_ERR_WITNESS_PROGRAM_WRONG_LENGTH);
         }
@@ -1975,7 +2006,9 @@ bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const C
     if (!EvalScript(stack, scriptSig, flags, checker, SigVersion::BASE, serror))
         // serror is set
         return false;
-    if (flags & SCRIPT_VERIFY_P2SH)
+    // The stack is only needed again to evaluate a P2SH redeem script
+    const bool is_p2sh{(flags & SCRIPT_VERIFY_P2SH) && scriptPubKey.IsPayToScriptHash()};
+    if (is_p2sh)
         stackCopy = stack;
     if (!EvalScript(stack, scriptPubKey, flags, checker, SigVersion::BASE, serror))
         // serror is set
@@ -2005,7 +2038,7 @@ bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const C
     }
 
     // Additional validation for spend-to-script-hash transactions:
-    if ((flags & SCRIPT_VERIFY_P2SH) && scriptPubKey.IsPayToScriptHash())
+    if (is_p2sh)
     {
         // scriptSig must be literals-only or validation fails
         if (!scriptSig.IsPushOnly())
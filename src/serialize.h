@@ -13,6 +13,7 @@
 #include <span.h>
 
 #include <algorithm>
+#include <array>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
@@ -241,6 +242,29 @@ const Out& AsBase(const In& x)
     BASE_SERIALIZE_METHODS(cls)     \
     FORMATTER_METHODS(cls, obj)
 
+/**
+ * Like SERIALIZE_METHODS, for types that always serialize to exactly `size` bytes
+ * and do not use stream parameters. The object is (de)serialized through a
+ * buffer on the stack, so the stream sees a single write() or read() call
+ * instead of one per field, and its serialized size is known without
+ * serializing it.
+ */
+#define SERIALIZE_METHODS_FIXED_SIZE(cls, obj, size)                                                \
+    static constexpr size_t SERIALIZED_SIZE{size};                                                  \
+    template <typename Stream>                                                                      \
+    void Serialize(Stream& s) const                                                                 \
+    {                                                                                               \
+        static_assert(std::is_same<const cls&, decltype(*this)>::value, "Serialize type mismatch"); \
+        SerializeFixedSize(s, *this);                                                               \
+    }                                                                                               \
+    template <typename Stream>                                                                      \
+    void Unserialize(Stream& s)                                                                     \
+    {                                                                                               \
+        static_assert(std::is_same<cls&, decltype(*this)>::value, "Unserialize type mismatch");     \
+        UnserializeFixedSize(s, *this);                                                             \
+    }                                                                                               \
+    FORMATTER_METHODS(cls, obj)
+
 // Templates for serializing to anything that looks like a stream,
 // i.e. anything that supports .read(Span<std::byte>) and .write(Span<const std::byte>)
 //
@@ -1103,6 +1127,61 @@ size_t GetSerializeSize(const T& t)
     return (SizeComputer() << t).size();
 }
 
+/** Minimal stream over a fixed size buffer, used by SERIALIZE_METHODS_FIXED_SIZE. */
+template <size_t N>
+class FixedSizeBuffer
+{
+    std::array<std::byte, N> m_data;
+    size_t m_pos{0};
+
+public:
+    void write(Span<const std::byte> src)
+    {
+        if (src.size() > N - m_pos) throw std::ios_base::failure("FixedSizeBuffer::write(): size exceeded");
+        std::memcpy(m_data.data() + m_pos, src.data(), src.size());
+        m_pos += src.size();
+    }
+
+    void read(Span<std::byte> dst)
+    {
+        if (dst.size() > N - m_pos) throw std::ios_base::failure("FixedSizeBuffer::read(): end of data");
+        std::memcpy(dst.data(), m_data.data() + m_pos, dst.size());
+        m_pos += dst.size();
+    }
+
+    template <typename T> FixedSizeBuffer& operator<<(const T& obj) { ::Serialize(*this, obj); return *this; }
+    template <typename T> FixedSizeBuffer& operator>>(T&& obj) { ::Unserialize(*this, obj); return *this; }
+
+    //! Whether exactly N bytes were written to or read from the buffer.
+    bool IsComplete() const { return m_pos == N; }
+
+    Span<std::byte> data() { return m_data; }
+    Span<const std::byte> data() const { return m_data; }
+};
+
+template <typename Stream, typename T>
+void SerializeFixedSize(Stream& s, const T& obj)
+{
+    if constexpr (std::is_same_v<Stream, SizeComputer>) {
+        s.seek(T::SERIALIZED_SIZE);
+    } else {
+        FixedSizeBuffer<T::SERIALIZED_SIZE> buf;
+        T::Ser(buf, obj);
+        // Writing fewer bytes than SERIALIZED_SIZE would emit uninitialized ones.
+        if (!buf.IsComplete()) throw std::ios_base::failure("SerializeFixedSize(): SERIALIZED_SIZE exceeds the serialized size");
+        s.write(buf.data());
+    }
+}
+
+template <typename Stream, typename T>
+void UnserializeFixedSize(Stream& s, T& obj)
+{
+    FixedSizeBuffer<T::SERIALIZED_SIZE> buf;
+    s.read(buf.data());
+    T::Unser(buf, obj);
+    if (!buf.IsComplete()) throw std::ios_base::failure("UnserializeFixedSize(): SERIALIZED_SIZE exceeds the serialized size");
+}
+
 //! Check if type contains a stream by seeing if has a GetStream() method.
 template<typename T>
 concept ContainsStream = requires(T t) { t.GetStream(); };
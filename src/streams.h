@@ -8,13 +8,15 @@
 
 #include <serialize.h>
 #include <span.h>
-#include <support/allocators/zeroafterfree.h>
+#include <support/allocators/bufferpool.h>
 #include <util/overflow.h>
 
 #include <algorithm>
+#include <array>
 #include <assert.h>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
 #include <ios>
 #include <limits>
 #include <optional>
@@ -32,6 +34,30 @@ inline void Xor(Span<std::byte> write, Span<const std::byte> key, size_t key_off
     }
     key_offset %= key.size();
 
+    if (sizeof(uint64_t) % key.size() == 0) {
+        // Keys that evenly divide a machine word, such as the 8 byte keys used
+        // to obfuscate the block files and the chainstate, are applied a word
+        // at a time, which the compiler can vectorize further.
+        std::array<std::byte, sizeof(uint64_t)> key_bytes;
+        for (size_t i = 0; i < key_bytes.size(); ++i) {
+            key_bytes[i] = key[(key_offset + i) % key.size()];
+        }
+        uint64_t key_word;
+        std::memcpy(&key_word, key_bytes.data(), sizeof(key_word));
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= write.size(); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, write.data() + i, sizeof(word));
+            word ^= key_word;
+            std::memcpy(write.data() + i, &word, sizeof(word));
+        }
+        for (; i != write.size(); ++i) {
+            write[i] ^= key_bytes[i % sizeof(uint64_t)];
+        }
+        return;
+    }
+
     for (size_t i = 0, j = key_offset; i != write.size(); i++) {
         write[i] ^= key[j++];
 
@@ -138,6 +164,12 @@ public:
     }
 };
 
+/** Tag for constructing a DataStream that only ever holds public data. */
+struct PublicDataTag {
+    explicit PublicDataTag() = default;
+};
+inline constexpr PublicDataTag PUBLIC_DATA{};
+
 /** Double ended buffer combining vector and stream-like interfaces.
  *
  * >> and << read and write unformatted data using the above serialization templates.
@@ -146,7 +178,7 @@ public:
 class DataStream
 {
 protected:
-    using vector_type = SerializeData;
+    using vector_type = std::vector<std::byte, stream_allocator<std::byte>>;
     vector_type vch;
     vector_type::size_type m_read_pos{0};
 
@@ -164,6 +196,9 @@ public:
     explicit DataStream() = default;
     explicit DataStream(Span<const uint8_t> sp) : DataStream{AsBytes(sp)} {}
     explicit DataStream(Span<const value_type> sp) : vch(sp.data(), sp.data() + sp.size()) {}
+    /** Construct a stream for data that is never secret, such as P2P messages. Its buffer is not
+     * cleared on free and small buffers are recycled, see stream_allocator. */
+    explicit DataStream(PublicDataTag) : vch(allocator_type{/*public_data=*/true}) {}
 
     std::string str() const
     {
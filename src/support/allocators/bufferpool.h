@@ -0,0 +1,153 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_BUFFERPOOL_H
+#define BITCOIN_SUPPORT_ALLOCATORS_BUFFERPOOL_H
+
+#include <support/cleanse.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Thread-safe pool of recycled small byte buffers.
+ *
+ * Buffers are grouped in power-of-two size classes from MIN_BUFFER_SIZE to MAX_BUFFER_SIZE. Freed
+ * buffers are kept on a per-class free list (up to MAX_FREE_PER_CLASS of them) and handed out again
+ * by the next allocation of that class, so that short-lived buffers such as P2P messages do not hit
+ * the heap each time. Larger requests are passed straight through to operator new.
+ *
+ * Buffers are not cleared when returned to the pool, so it must only be used for public data.
+ */
+class BufferPool
+{
+public:
+    static constexpr size_t MIN_BUFFER_SIZE{64};
+    static constexpr size_t MAX_BUFFER_SIZE{4096};
+    static constexpr size_t MAX_FREE_PER_CLASS{128};
+    static constexpr size_t NUM_CLASSES{std::bit_width(MAX_BUFFER_SIZE / MIN_BUFFER_SIZE)};
+
+    /** Index of the size class serving an allocation of bytes <= MAX_BUFFER_SIZE. */
+    static constexpr size_t ClassIndex(size_t bytes) noexcept
+    {
+        if (bytes <= MIN_BUFFER_SIZE) return 0;
+        return std::bit_width(bytes - 1) - std::bit_width(MIN_BUFFER_SIZE - 1);
+    }
+
+    /** Size of the buffers in size class index. */
+    static constexpr size_t ClassSize(size_t index) noexcept { return MIN_BUFFER_SIZE << index; }
+
+    BufferPool()
+    {
+        for (auto& free_list : m_free) free_list.reserve(MAX_FREE_PER_CLASS);
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /** Process-wide pool. Never destroyed, so that buffers may be freed during static destruction. */
+    static BufferPool& Instance()
+    {
+        static BufferPool* const pool{new BufferPool()};
+        return *pool;
+    }
+
+    void* Allocate(size_t bytes)
+    {
+        if (bytes > MAX_BUFFER_SIZE) return ::operator new(bytes);
+        const size_t index{ClassIndex(bytes)};
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& free_list{m_free[index]};
+            if (!free_list.empty()) {
+                void* p{free_list.back()};
+                free_list.pop_back();
+                return p;
+            }
+        }
+        return ::operator new(ClassSize(index));
+    }
+
+    /** Return a buffer obtained from Allocate(bytes), with the same bytes. */
+    void Deallocate(void* p, size_t bytes) noexcept
+    {
+        if (p == nullptr) return;
+        if (bytes <= MAX_BUFFER_SIZE) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& free_list{m_free[ClassIndex(bytes)]};
+            if (free_list.size() < MAX_FREE_PER_CLASS) {
+                free_list.push_back(p);
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::array<std::vector<void*>, NUM_CLASSES> m_free;
+};
+
+static_assert(BufferPool::ClassIndex(BufferPool::MAX_BUFFER_SIZE) == BufferPool::NUM_CLASSES - 1);
+static_assert(BufferPool::ClassSize(BufferPool::NUM_CLASSES - 1) == BufferPool::MAX_BUFFER_SIZE);
+
+/**
+ * Allocator for serialization buffers.
+ *
+ * By default it behaves like zero_after_free_allocator and clears memory before freeing it. An
+ * allocator constructed with public_data=true is meant for buffers that never hold secrets, such
+ * as P2P messages: it skips the clearing and recycles small buffers through BufferPool.
+ *
+ * The flag travels with the buffer on copy, move and swap, so memory is always released the way it
+ * was obtained.
+ */
+template <typename T>
+struct stream_allocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    bool m_public_data{false};
+
+    constexpr stream_allocator() noexcept = default;
+    constexpr explicit stream_allocator(bool public_data) noexcept : m_public_data{public_data} {}
+    template <typename U>
+    constexpr stream_allocator(const stream_allocator<U>& other) noexcept : m_public_data{other.m_public_data}
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (m_public_data) return static_cast<T*>(BufferPool::Instance().Allocate(sizeof(T) * n));
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if (m_public_data) {
+            BufferPool::Instance().Deallocate(p, sizeof(T) * n);
+            return;
+        }
+        if (p != nullptr)
+            memory_cleanse(p, sizeof(T) * n);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    friend bool operator==(const stream_allocator& a, const stream_allocator<U>& b) noexcept
+    {
+        return a.m_public_data == b.m_public_data;
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_BUFFERPOOL_H
@@ -119,6 +119,11 @@ class PoolResource final
      */
     std::byte* m_available_memory_end = nullptr;
 
+    /**
+     * Bytes of the blocks served from the chunks that have not been deallocated yet.
+     */
+    std::size_t m_num_bytes_in_use = 0;
+
     /**
      * How many multiple of ELEM_ALIGN_BYTES are necessary to fit bytes. We use that result directly as an index
      * into m_free_lists. Round up for the special case when bytes==0.
@@ -213,6 +218,7 @@ public:
     {
         if (IsFreeListUsable(bytes, alignment)) {
             const std::size_t num_alignments = NumElemAlignBytes(bytes);
+            m_num_bytes_in_use += num_alignments * ELEM_ALIGN_BYTES;
             if (nullptr != m_free_lists[num_alignments]) {
                 // we've already got data in the pool's freelist, unlink one element and return the pointer
                 // to the unlinked memory. Since FreeList is trivially destructible we can just treat it as
@@ -242,6 +248,7 @@ public:
     {
         if (IsFreeListUsable(bytes, alignment)) {
             const std::size_t num_alignments = NumElemAlignBytes(bytes);
+            m_num_bytes_in_use -= num_alignments * ELEM_ALIGN_BYTES;
             // put the memory block into the linked list. We can placement construct the FreeList
             // into the memory since we can be sure the alignment is correct.
             PlacementAddToList(p, m_free_lists[num_alignments]);
@@ -259,6 +266,15 @@ public:
         return m_allocated_chunks.size();
     }
 
+    /**
+     * Number of bytes of the chunks taken by blocks that are currently allocated. Blocks returned
+     * to the freelists do not count, although their chunks are not released.
+     */
+    [[nodiscard]] std::size_t NumBytesInUse() const
+    {
+        return m_num_bytes_in_use;
+    }
+
     /**
      * Size in bytes to allocate per chunk, currently hardcoded to a fixed size.
      */
@@ -0,0 +1,274 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockdownloadwindow.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+using namespace std::chrono_literals;
+using std::chrono::microseconds;
+
+namespace {
+
+/** Same as BLOCK_DOWNLOAD_WINDOW in net_processing. */
+constexpr int BLOCK_DOWNLOAD_WINDOW{1024};
+
+struct InFlightBlock {
+    int height;
+    microseconds requested_time;
+    microseconds arrival_time;
+};
+
+/**
+ * A peer serving the blocks we request from it one after another, over a link with a fixed round
+ * trip time and a bandwidth that can vary from block to block.
+ */
+struct SimulatedPeer {
+    microseconds rtt;
+    double bytes_per_sec;
+    /** Random variation of the time taken to send each block, as a fraction of it. */
+    double jitter{0};
+
+    BlockDownloadWindow window{};
+    std::deque<InFlightBlock> in_flight{};
+    /** When the peer is done sending the blocks requested so far. */
+    microseconds link_free{0};
+
+    /** Request a block at time now; it is queued behind the ones already in flight. */
+    void Request(int height, microseconds now, size_t block_size, FastRandomContext& rng)
+    {
+        const double variation{jitter * (2 * rng.randrange(1001) / 1000.0 - 1)};
+        const auto send_time{std::chrono::duration_cast<microseconds>(SecondsDouble{block_size / bytes_per_sec * (1 + variation)})};
+        link_free = std::max(now + rtt / 2, link_free) + send_time;
+        in_flight.push_back({height, now, link_free + rtt / 2});
+    }
+
+    /** Number of blocks the peer could deliver while a request makes its round trip. */
+    double BandwidthDelayProduct(size_t block_size) const { return Ticks<SecondsDouble>(rtt) * bytes_per_sec / block_size; }
+};
+
+/** Download num_blocks blocks from a single peer, as many at once as its window allows. Returns
+ *  the bytes per second achieved. */
+double Download(SimulatedPeer& peer, microseconds& now, int num_blocks, size_t block_size, FastRandomContext& rng)
+{
+    const microseconds start{now};
+    int requested{0};
+    for (int received = 0; received < num_blocks; ++received) {
+        while (requested < num_blocks && peer.in_flight.size() < peer.window.GetLimit()) {
+            peer.Request(requested++, now, block_size, rng);
+        }
+        const InFlightBlock block{peer.in_flight.front()};
+        peer.in_flight.pop_front();
+        now = block.arrival_time;
+        peer.window.BlockReceived(block.requested_time, now, block_size, peer.rtt);
+    }
+    return num_blocks * block_size / Ticks<SecondsDouble>(now - start);
+}
+
+/**
+ * Download a chain of blocks from several peers at once, the way net_processing schedules block
+ * downloads during IBD. Blocks are assigned in order to peers with room in their window, and never
+ * further than BLOCK_DOWNLOAD_WINDOW beyond the first missing block. If race_staller is set, a
+ * peer with nothing in flight and nothing left to fetch in the window is also asked for the first
+ * missing block, unless that is already requested from two peers.
+ *
+ * This is a model of the scheduler, not net_processing itself: it checks the window limits
+ * computed by BlockDownloadWindow, while the staller racing in PeerManagerImpl is only covered by
+ * the p2p_ibd_stalling functional test.
+ *
+ * Returns the time it took to receive every block.
+ */
+microseconds DownloadChain(std::vector<SimulatedPeer>& peers, int num_blocks, size_t block_size,
+                           const std::function<size_t(const SimulatedPeer&)>& limit, bool race_staller)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<bool> received(num_blocks);
+    std::vector<int> requests(num_blocks);
+    int first_missing{0};
+    int next_to_request{0};
+    microseconds now{0};
+
+    while (first_missing < num_blocks) {
+        for (auto& peer : peers) {
+            while (peer.in_flight.size() < limit(peer) && next_to_request < std::min(num_blocks, first_missing + BLOCK_DOWNLOAD_WINDOW)) {
+                ++requests[next_to_request];
+                peer.Request(next_to_request++, now, block_size, rng);
+            }
+            if (race_staller && peer.in_flight.empty() && requests[first_missing] == 1) {
+                ++requests[first_missing];
+                peer.Request(first_missing, now, block_size, rng);
+            }
+        }
+
+        // Receive the next block to arrive.
+        auto& peer{*std::min_element(peers.begin(), peers.end(), [](const auto& a, const auto& b) {
+            if (a.in_flight.empty() || b.in_flight.empty()) return b.in_flight.empty() && !a.in_flight.empty();
+            return a.in_flight.front().arrival_time < b.in_flight.front().arrival_time;
+        })};
+        BOOST_REQUIRE(!peer.in_flight.empty());
+        const InFlightBlock block{peer.in_flight.front()};
+        peer.in_flight.pop_front();
+        now = block.arrival_time;
+        peer.window.BlockReceived(block.requested_time, now, block_size, peer.rtt);
+
+        // Like RemoveBlockRequest, forget the other request for the block. The other peer still
+        // spends the bandwidth to send it.
+        received[block.height] = true;
+        for (auto& other : peers) {
+            std::erase_if(other.in_flight, [&](const auto& b) { return b.height == block.height; });
+        }
+        while (first_missing < num_blocks && received[first_missing]) ++first_missing;
+    }
+    return now;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(blockdownloadwindow_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(unmeasured)
+{
+    BlockDownloadWindow window;
+    BOOST_CHECK_EQUAL(window.GetLimit(), DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER);
+    BOOST_CHECK(!window.GetStats().bytes_per_sec);
+    BOOST_CHECK(!window.GetStats().latency);
+
+    // Blocks received without time passing, e.g. under mocktime, can't be measured.
+    window.BlockReceived(10s, 10s, 1000, std::nullopt);
+    BOOST_CHECK_EQUAL(window.GetLimit(), DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER);
+    BOOST_CHECK_EQUAL(window.GetStats().blocks_received, 1U);
+    BOOST_CHECK(!window.GetStats().bytes_per_sec);
+
+    // Without a round trip time, the throughput is measured but the limit can't be adapted.
+    window.BlockReceived(10s, 11s, 1000, std::nullopt);
+    BOOST_CHECK_EQUAL(window.GetLimit(), DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER);
+    BOOST_CHECK_EQUAL(*window.GetStats().bytes_per_sec, 1000.0);
+    BOOST_CHECK(*window.GetStats().latency == 1s);
+
+    window.BlockReceived(11s, 12s, 1000, 50ms);
+    BOOST_CHECK_EQUAL(window.GetLimit(), MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+}
+
+BOOST_AUTO_TEST_CASE(service_time)
+{
+    BlockDownloadWindow window;
+    // Three blocks requested at once arrive one second apart. The peer was busy with the first one
+    // until it arrived, so the others only count from the arrival of the previous one.
+    window.BlockReceived(0s, 1s, 1000, 1s);
+    window.BlockReceived(0s, 2s, 1000, 1s);
+    window.BlockReceived(0s, 3s, 1000, 1s);
+    const auto stats{window.GetStats()};
+    BOOST_CHECK_EQUAL(*stats.bytes_per_sec, 1000.0);
+    BOOST_CHECK(*stats.latency > 1s && *stats.latency < 3s);
+    BOOST_CHECK_EQUAL(stats.blocks_received, 3U);
+    // One block per round trip. Twice that, plus the block being sent, is below the minimum.
+    BOOST_CHECK_EQUAL(window.GetLimit(), MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+}
+
+BOOST_AUTO_TEST_CASE(bandwidth_delay_product)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    struct Link {
+        microseconds rtt;
+        double bytes_per_sec;
+        size_t block_size;
+    };
+    for (const Link& link : {
+             Link{20ms, 100e6, 1'000'000},   // Nearby peer on a fast link
+             Link{300ms, 50e6, 1'000'000},   // Distant peer on a fast link
+             Link{150ms, 20e6, 250'000},     // Intercontinental peer
+             Link{100ms, 10e6, 250},         // Early IBD, where blocks are tiny
+             Link{500ms, 100e3, 1'000'000},  // Slow peer
+         }) {
+        SimulatedPeer peer{.rtt = link.rtt, .bytes_per_sec = link.bytes_per_sec, .jitter = 0.5};
+        microseconds now{0};
+        Download(peer, now, 200, link.block_size, rng);
+        const double bytes_per_sec{Download(peer, now, 500, link.block_size, rng)};
+
+        // The limit covers the bandwidth-delay product, with about a factor two to spare.
+        const double bdp{peer.BandwidthDelayProduct(link.block_size)};
+        const size_t limit{peer.window.GetLimit()};
+        BOOST_CHECK_GE(limit, std::min<double>(bdp, MAX_BLOCKS_IN_TRANSIT_PER_PEER));
+        BOOST_CHECK_LE(limit, std::max<double>(2.5 * bdp + 2, MIN_BLOCKS_IN_TRANSIT_PER_PEER));
+        BOOST_CHECK_GE(limit, MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+        BOOST_CHECK_LE(limit, MAX_BLOCKS_IN_TRANSIT_PER_PEER);
+        // Which keeps the link busy, unless the limit is capped.
+        if (bdp < MAX_BLOCKS_IN_TRANSIT_PER_PEER) BOOST_CHECK_GE(bytes_per_sec, 0.9 * link.bytes_per_sec);
+        // The measured rate is within the jitter of the real one.
+        BOOST_CHECK_GE(*peer.window.GetStats().bytes_per_sec, 0.6 * link.bytes_per_sec);
+        BOOST_CHECK_LE(*peer.window.GetStats().bytes_per_sec, 1.5 * link.bytes_per_sec);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(variable_bandwidth)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    constexpr size_t BLOCK_SIZE{1'000'000};
+    SimulatedPeer peer{.rtt = 200ms, .bytes_per_sec = 50e6, .jitter = 0.2};
+    microseconds now{0};
+
+    Download(peer, now, 200, BLOCK_SIZE, rng);
+    const size_t fast_limit{peer.window.GetLimit()};
+    BOOST_CHECK_GE(fast_limit, peer.BandwidthDelayProduct(BLOCK_SIZE));
+
+    // The peer's link gets congested: the limit drops, so it holds on to fewer blocks.
+    peer.bytes_per_sec = 1e6;
+    Download(peer, now, 50, BLOCK_SIZE, rng);
+    BOOST_CHECK_EQUAL(peer.window.GetLimit(), MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+
+    // And grows back once the congestion clears.
+    peer.bytes_per_sec = 50e6;
+    Download(peer, now, 200, BLOCK_SIZE, rng);
+    BOOST_CHECK_GE(peer.window.GetLimit(), peer.BandwidthDelayProduct(BLOCK_SIZE));
+    BOOST_CHECK_LE(peer.window.GetLimit(), fast_limit + fast_limit / 2);
+    BOOST_CHECK_GE(Download(peer, now, 200, BLOCK_SIZE, rng), 0.9 * peer.bytes_per_sec);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_download)
+{
+    const auto fixed_limit{[](const SimulatedPeer&) { return DEFAULT_BLOCKS_IN_TRANSIT_PER_PEER; }};
+    const auto adaptive_limit{[](const SimulatedPeer& peer) { return peer.window.GetLimit(); }};
+
+    const std::vector<SimulatedPeer> fast_peers{
+        {.rtt = 50ms, .bytes_per_sec = 20e6, .jitter = 0.5},
+        {.rtt = 150ms, .bytes_per_sec = 10e6, .jitter = 0.5},
+        {.rtt = 300ms, .bytes_per_sec = 10e6, .jitter = 0.5},
+    };
+    auto with_slow_peer{fast_peers};
+    with_slow_peer.push_back({.rtt = 400ms, .bytes_per_sec = 50e3, .jitter = 0.5});
+
+    // Small blocks: a fixed limit of 16 leaves the links idle for most of each round trip.
+    {
+        auto fixed_peers{fast_peers}, adaptive_peers{fast_peers};
+        const auto fixed{DownloadChain(fixed_peers, 5000, 20'000, fixed_limit, /*race_staller=*/false)};
+        const auto adaptive{DownloadChain(adaptive_peers, 5000, 20'000, adaptive_limit, /*race_staller=*/true)};
+        BOOST_CHECK_LT(adaptive * 3, fixed);
+    }
+
+    // Large blocks with a slow peer: the slow peer holds back the download window until its
+    // blocks are raced by the idle fast peers.
+    {
+        auto fixed_peers{with_slow_peer}, adaptive_peers{with_slow_peer};
+        const auto fixed{DownloadChain(fixed_peers, 2000, 1'000'000, fixed_limit, /*race_staller=*/false)};
+        const auto adaptive{DownloadChain(adaptive_peers, 2000, 1'000'000, adaptive_limit, /*race_staller=*/true)};
+        BOOST_CHECK_LT(adaptive * 2, fixed);
+        // The fast peers' links are close to saturated.
+        const double total_bytes_per_sec{40e6};
+        BOOST_CHECK_LT(Ticks<SecondsDouble>(adaptive), 1.25 * 2000 * 1'000'000 / total_bytes_per_sec);
+        BOOST_CHECK_EQUAL(adaptive_peers.back().window.GetLimit(), MIN_BLOCKS_IN_TRANSIT_PER_PEER);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
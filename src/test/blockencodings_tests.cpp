@@ -266,6 +266,67 @@ BOOST_AUTO_TEST_CASE(SufficientPreforwardRTTest)
     BOOST_CHECK_EQUAL(pool.get(txhash).use_count(), SHARED_TX_OFFSET - 1); // -1 because of block
 }
 
+BOOST_AUTO_TEST_CASE(PredictedPrefillRoundTripTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    auto rand_ctx(FastRandomContext(uint256{42}));
+    CBlock block(BuildBlockTestCase(rand_ctx));
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, rand_ctx.rand64()};
+    const TestHeaderAndShortIDs shared{cmpctblock};
+
+    // Only the predicted transaction is prefilled, at its offset from the coinbase, and the nonce
+    // and short IDs of the others are kept
+    {
+        TestHeaderAndShortIDs shortIDs{CBlockHeaderAndShortTxIDs{cmpctblock, block, {2}}};
+        BOOST_CHECK_EQUAL(shortIDs.nonce, shared.nonce);
+        BOOST_REQUIRE_EQUAL(shortIDs.prefilledtxn.size(), 2U);
+        BOOST_CHECK_EQUAL(shortIDs.prefilledtxn[1].index, 1);
+        BOOST_CHECK(shortIDs.prefilledtxn[1].tx->GetHash() == block.vtx[2]->GetHash());
+        BOOST_REQUIRE_EQUAL(shortIDs.shorttxids.size(), 1U);
+        BOOST_CHECK_EQUAL(shortIDs.shorttxids[0], shared.shorttxids[0]);
+
+        DataStream stream{};
+        stream << shortIDs;
+
+        CBlockHeaderAndShortTxIDs shortIDs2;
+        stream >> shortIDs2;
+
+        PartiallyDownloadedBlock partialBlock(&pool);
+        BOOST_CHECK(partialBlock.InitData(shortIDs2, empty_extra_txn) == READ_STATUS_OK);
+        BOOST_CHECK( partialBlock.IsTxAvailable(0));
+        BOOST_CHECK(!partialBlock.IsTxAvailable(1));
+        BOOST_CHECK( partialBlock.IsTxAvailable(2));
+
+        CBlock block2;
+        BOOST_CHECK(partialBlock.FillBlock(block2, {block.vtx[1]}) == READ_STATUS_OK);
+        BOOST_CHECK_EQUAL(block.GetHash().ToString(), block2.GetHash().ToString());
+    }
+
+    // With all transactions predicted, the block is reconstructed without a round trip
+    {
+        CBlockHeaderAndShortTxIDs shortIDs{cmpctblock, block, {1, 2}};
+
+        DataStream stream{};
+        stream << shortIDs;
+
+        CBlockHeaderAndShortTxIDs shortIDs2;
+        stream >> shortIDs2;
+
+        PartiallyDownloadedBlock partialBlock(&pool);
+        BOOST_CHECK(partialBlock.InitData(shortIDs2, empty_extra_txn) == READ_STATUS_OK);
+        for (size_t i = 0; i < block.vtx.size(); i++) {
+            BOOST_CHECK(partialBlock.IsTxAvailable(i));
+        }
+
+        CBlock block2;
+        BOOST_CHECK(partialBlock.FillBlock(block2, {}) == READ_STATUS_OK);
+        BOOST_CHECK_EQUAL(block.GetHash().ToString(), block2.GetHash().ToString());
+        bool mutated;
+        BOOST_CHECK_EQUAL(block.hashMerkleRoot.ToString(), BlockMerkleRoot(block2, &mutated).ToString());
+        BOOST_CHECK(!mutated);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(EmptyBlockRoundTripTest)
 {
     CTxMemPool& pool = *Assert(m_node.mempool);
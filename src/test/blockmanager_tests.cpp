@@ -198,4 +198,45 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_archive_block_file)
+{
+    KernelNotifications notifications{*Assert(m_node.shutdown), m_node.exit_status, *Assert(m_node.warnings)};
+    const fs::path archive_dir{m_args.GetDataDirBase() / "archive"};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .blocks_archive_dir = archive_dir,
+        .blocks_archive_depth = 288,
+    };
+    // Use small block files
+    blockman_opts.fast_prune = true;
+    BlockManager blockman{*Assert(m_node.shutdown), blockman_opts};
+
+    // Fill the first block file
+    const CBlock& block{Params().GenesisBlock()};
+    const FlatFilePos first_pos{blockman.SaveBlockToDisk(block, /*nHeight=*/0)};
+    int height{0};
+    while (blockman.SaveBlockToDisk(block, ++height).nFile == 0) {}
+    const int last_height_in_file{height - 1};
+    const fs::path blk_file{blockman.GetBlockPosFilename(first_pos)};
+
+    // The file is not archived before all its blocks are deep enough...
+    BOOST_CHECK(!blockman.ArchiveBlockFile(last_height_in_file + 287));
+    BOOST_CHECK(fs::exists(blk_file));
+    // ...and the file currently written to never is. Files are copied a chunk
+    // at a time, and the small ones used here take a single call.
+    BOOST_CHECK(blockman.ArchiveBlockFile(height + 1000));
+    BOOST_CHECK(!blockman.ArchiveBlockFile(height + 1000));
+
+    BOOST_CHECK(!fs::exists(blk_file));
+    BOOST_CHECK(fs::exists(archive_dir / "blk00000.dat"));
+    BOOST_CHECK(blockman.GetBlockPosFilename(first_pos) == archive_dir / "blk00000.dat");
+
+    // Blocks are read from the archive transparently
+    CBlock read_block;
+    BOOST_CHECK(blockman.ReadBlockFromDisk(read_block, first_pos));
+    BOOST_CHECK_EQUAL(read_block.GetHash(), block.GetHash());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1100,6 +1100,46 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_partitioned_cursors)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    {
+        CCoinsViewCache cache{&base};
+        for (int i = 0; i < 1000; ++i) {
+            const Txid txid{Txid::FromUint256(m_rng.rand256())};
+            for (uint32_t n = 0; n < 1 + m_rng.randrange(3U); ++n) {
+                cache.AddCoin(COutPoint{txid, n}, Coin{CTxOut{int64_t(m_rng.randrange(1000)), CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/false);
+            }
+        }
+        cache.SetBestBlock(m_rng.rand256());
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    const auto collect_keys{[](CCoinsViewCursor& cursor, std::vector<COutPoint>& keys) {
+        for (; cursor.Valid(); cursor.Next()) {
+            COutPoint key;
+            BOOST_REQUIRE(cursor.GetKey(key));
+            keys.push_back(key);
+        }
+    }};
+
+    std::vector<COutPoint> all_keys;
+    collect_keys(*base.Cursor(), all_keys);
+    BOOST_CHECK(all_keys.size() >= 1000);
+
+    // Concatenating the partitions in order must yield exactly the full cursor.
+    for (size_t num_partitions : {1, 2, 3, 7, 16, 300}) {
+        const auto cursors{base.PartitionedCursors(num_partitions)};
+        BOOST_REQUIRE_EQUAL(cursors.size(), num_partitions);
+        std::vector<COutPoint> partitioned_keys;
+        for (const auto& cursor : cursors) {
+            BOOST_CHECK(cursor->GetBestBlock() == base.GetBestBlock());
+            collect_keys(*cursor, partitioned_keys);
+        }
+        BOOST_CHECK(partitioned_keys == all_keys);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
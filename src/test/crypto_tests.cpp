@@ -352,6 +352,14 @@ void TestHKDF_SHA256_32(const std::string &ikm_hex, const std::string &salt_hex,
     unsigned char out[32];
     hkdf32.Expand32(info_stringified, out);
     BOOST_CHECK(HexStr(out) == okm_check_hex);
+
+    // Expanding the info together with others gives the same key.
+    const std::vector<std::string> infos{"other", info_stringified, std::string(128, 'x')};
+    unsigned char outs[3 * 32];
+    hkdf32.Expand32(infos, outs);
+    BOOST_CHECK(HexStr(Span{outs}.subspan(32, 32)) == okm_check_hex);
+    hkdf32.Expand32(infos[2], out);
+    BOOST_CHECK(HexStr(Span{outs}.subspan(64, 32)) == HexStr(out));
 }
 
 void TestSHA3_256(const std::string& input, const std::string& output);
@@ -1086,6 +1094,83 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256_multi)
+{
+    for (const auto implementation : {sha256_implementation::STANDARD, sha256_implementation::USE_SSE4_AND_AVX2, sha256_implementation::USE_ALL}) {
+        SHA256AutoDetect(implementation);
+        for (int i = 0; i <= 32; ++i) {
+            // Lengths around the block size and the padding boundaries, and longer ones.
+            std::vector<std::vector<unsigned char>> data;
+            for (int j = 0; j < i; ++j) {
+                const size_t len{m_rng.randbool() ? 48 + m_rng.randrange<size_t>(96) : m_rng.randrange<size_t>(1000)};
+                data.push_back(m_rng.randbytes(len));
+            }
+            std::vector<const unsigned char*> inputs;
+            std::vector<size_t> lengths;
+            for (const auto& d : data) {
+                inputs.push_back(d.data());
+                lengths.push_back(d.size());
+            }
+            std::vector<unsigned char> out1(32 * i), out2(32 * i);
+            for (int j = 0; j < i; ++j) {
+                CSHA256().Write(data[j].data(), data[j].size()).Finalize(out1.data() + 32 * j);
+            }
+            SHA256Multi(out2.data(), inputs.data(), lengths.data(), i);
+            BOOST_CHECK(out1 == out2);
+        }
+    }
+    SHA256AutoDetect();
+}
+
+BOOST_AUTO_TEST_CASE(ripemd160_32)
+{
+    for (int i = 0; i <= 32; ++i) {
+        unsigned char in[32 * 32];
+        unsigned char out1[20 * 32], out2[20 * 32];
+        for (int j = 0; j < 32 * i; ++j) {
+            in[j] = m_rng.randbits(8);
+        }
+        for (int j = 0; j < i; ++j) {
+            CRIPEMD160().Write(in + 32 * j, 32).Finalize(out1 + 20 * j);
+        }
+        RIPEMD160_32(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 20 * i) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash160_batch)
+{
+    std::vector<std::vector<unsigned char>> data;
+    for (int i = 0; i < 20; ++i) {
+        data.push_back(m_rng.randbytes(m_rng.randrange(100)));
+    }
+    const std::vector<Span<const unsigned char>> inputs(data.begin(), data.end());
+    const std::vector<uint160> hashes{Hash160Batch(inputs)};
+    BOOST_REQUIRE_EQUAL(hashes.size(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], Hash160(data[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash_batch)
+{
+    std::vector<std::vector<unsigned char>> data;
+    for (int i = 0; i < 20; ++i) {
+        data.push_back(m_rng.randbytes(m_rng.randrange(300)));
+    }
+    const std::vector<Span<const unsigned char>> inputs(data.begin(), data.end());
+    const std::vector<uint256> hashes{HashBatch(inputs)};
+    const std::vector<uint256> sha256s{SHA256Batch(inputs)};
+    BOOST_REQUIRE_EQUAL(hashes.size(), data.size());
+    BOOST_REQUIRE_EQUAL(sha256s.size(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], Hash(data[i]));
+        uint256 sha256;
+        CSHA256().Write(data[i].data(), data[i].size()).Finalize(sha256.begin());
+        BOOST_CHECK_EQUAL(sha256s[i], sha256);
+    }
+}
+
 void CryptoTest::TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
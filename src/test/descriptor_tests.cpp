@@ -385,6 +385,29 @@ void DoCheck(std::string prv, std::string pub, const std::string& norm_pub, int
         }
     }
 
+    // Expanding all positions at once gives the same results as expanding them one by one.
+    for (int t = 0; t < 2; ++t) {
+        const FlatSigningProvider& key_provider = (flags & HARDENED) ? keys_priv : keys_pub;
+        std::vector<std::vector<CScript>> range_spks, range_spks_cached;
+        std::vector<FlatSigningProvider> range_providers, range_providers_cached;
+        DescriptorCache desc_cache;
+        BOOST_CHECK((t ? parse_priv : parse_pub)->ExpandRange(0, max, key_provider, range_spks, range_providers, &desc_cache));
+        BOOST_CHECK(parse_pub->ExpandRangeFromCache(0, max, desc_cache, range_spks_cached, range_providers_cached));
+        BOOST_REQUIRE_EQUAL(range_spks.size(), max);
+        BOOST_REQUIRE_EQUAL(range_spks_cached.size(), max);
+        for (size_t i = 0; i < max; ++i) {
+            FlatSigningProvider script_provider;
+            std::vector<CScript> spks;
+            BOOST_CHECK((t ? parse_priv : parse_pub)->Expand(i, key_provider, spks, script_provider));
+            BOOST_CHECK(range_spks[i] == spks);
+            BOOST_CHECK(range_spks_cached[i] == spks);
+            BOOST_CHECK(GetKeyData(range_providers[i], flags) == GetKeyData(script_provider, flags));
+            BOOST_CHECK(range_providers[i].scripts == script_provider.scripts);
+            BOOST_CHECK(GetKeyOriginData(range_providers[i], flags) == GetKeyOriginData(script_provider, flags));
+            BOOST_CHECK(GetKeyOriginData(range_providers_cached[i], flags) == GetKeyOriginData(script_provider, flags));
+        }
+    }
+
     // Verify no expected paths remain that were not observed.
     BOOST_CHECK_MESSAGE(left_paths.empty(), "Not all expected key paths found: " + prv);
 }
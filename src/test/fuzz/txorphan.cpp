@@ -19,6 +19,7 @@
 #include <util/check.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <set>
@@ -33,7 +34,6 @@ void initialize_orphanage()
 FUZZ_TARGET(txorphan, .init = initialize_orphanage)
 {
     FuzzedDataProvider fuzzed_data_provider(buffer.data(), buffer.size());
-    FastRandomContext limit_orphans_rng{/*fDeterministic=*/true};
     SetMockTime(ConsumeTime(fuzzed_data_provider));
 
     TxOrphanage orphanage;
@@ -45,6 +45,8 @@ FUZZ_TARGET(txorphan, .init = initialize_orphanage)
     }
 
     CTransactionRef ptx_potential_parent = nullptr;
+    // Peers that may have orphans in the orphanage
+    std::set<NodeId> orphan_peers;
 
     LIMITED_WHILE(outpoints.size() < 200'000 && fuzzed_data_provider.ConsumeBool(), 10 * DEFAULT_MAX_ORPHAN_TRANSACTIONS)
     {
@@ -116,6 +118,7 @@ FUZZ_TARGET(txorphan, .init = initialize_orphanage)
                         bool add_tx = orphanage.AddTx(tx, peer_id);
                         // have_tx == true -> add_tx == false
                         Assert(!have_tx || !add_tx);
+                        if (add_tx) orphan_peers.insert(peer_id);
                     }
                     have_tx = orphanage.HaveTx(tx->GetWitnessHash());
                     {
@@ -139,15 +142,29 @@ FUZZ_TARGET(txorphan, .init = initialize_orphanage)
                 },
                 [&] {
                     orphanage.EraseForPeer(peer_id);
+                    Assert(orphanage.UsageByPeer(peer_id) == 0);
+                    orphan_peers.erase(peer_id);
                 },
                 [&] {
                     // test mocktime and expiry
                     SetMockTime(ConsumeTime(fuzzed_data_provider));
                     auto limit = fuzzed_data_provider.ConsumeIntegral<unsigned int>();
-                    orphanage.LimitOrphans(limit, limit_orphans_rng);
+                    orphanage.LimitOrphans(limit);
                     Assert(orphanage.Size() <= limit);
+                    // Each peer with orphans left is entitled to its reserved weight.
+                    const auto num_peers_with_orphans{std::count_if(orphan_peers.begin(), orphan_peers.end(),
+                                                                    [&](NodeId peer) { return orphanage.UsageByPeer(peer) > 0; })};
+                    Assert(orphanage.TotalOrphanUsage() <= RESERVED_ORPHAN_WEIGHT_PER_PEER * num_peers_with_orphans);
                 });
 
+            // The usage of all orphans is the sum of the usage of each peer's orphans.
+            int64_t usage_by_peers{0};
+            for (const NodeId peer : orphan_peers) {
+                Assert(orphanage.UsageByPeer(peer) >= 0);
+                usage_by_peers += orphanage.UsageByPeer(peer);
+            }
+            Assert(usage_by_peers == orphanage.TotalOrphanUsage());
+
         }
         // Set tx as potential parent to be used for future GetChildren() calls.
         if (!ptx_potential_parent || fuzzed_data_provider.ConsumeBool()) {
@@ -0,0 +1,84 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <hash.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <script/script_error.h>
+#include <test/fuzz/FuzzedDataProvider.h>
+#include <test/fuzz/fuzz.h>
+#include <test/fuzz/util.h>
+#include <test/util/script.h>
+#include <uint256.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace {
+class ConstantSignatureChecker : public BaseSignatureChecker
+{
+    const bool m_result;
+
+public:
+    explicit ConstantSignatureChecker(bool result) : m_result{result} {}
+
+    bool CheckECDSASignature(const std::vector<unsigned char>& scriptSig, const std::vector<unsigned char>& vchPubKey, const CScript& scriptCode, SigVersion sigversion) const override
+    {
+        return m_result;
+    }
+};
+} // namespace
+
+//! Check that P2WPKH spends, which are verified without running the script
+//! interpreter, give the same result and error as interpreting the script
+//! they imply.
+FUZZ_TARGET(witness_v0_keyhash)
+{
+    FuzzedDataProvider fuzzed_data_provider(buffer.data(), buffer.size());
+    const unsigned int flags{fuzzed_data_provider.ConsumeIntegral<unsigned int>() | SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_WITNESS};
+    if (!IsValidFlagCombination(flags)) return;
+    const ConstantSignatureChecker checker{fuzzed_data_provider.ConsumeBool()};
+
+    CScriptWitness witness;
+    witness.stack.push_back(ConsumeRandomLengthByteVector(fuzzed_data_provider));
+    witness.stack.push_back(ConsumeRandomLengthByteVector(fuzzed_data_provider));
+    std::vector<unsigned char> program(uint160::size());
+    if (fuzzed_data_provider.ConsumeBool()) {
+        CHash160().Write(witness.stack[1]).Finalize(program);
+    } else {
+        program = fuzzed_data_provider.ConsumeBytes<unsigned char>(uint160::size());
+        program.resize(uint160::size());
+    }
+    // An all-zero program fails as a scriptPubKey, before the witness is looked at
+    if (std::ranges::all_of(program, [](unsigned char c) { return c == 0; })) return;
+
+    ScriptError fast_error;
+    const bool fast_result{VerifyScript(CScript{}, CScript{} << OP_0 << program, &witness, flags, checker, &fast_error)};
+
+    // Interpret the implied script the way ExecuteWitnessScript would
+    const CScript exec_script{CScript{} << OP_DUP << OP_HASH160 << program << OP_EQUALVERIFY << OP_CHECKSIG};
+    ScriptError error{SCRIPT_ERR_OK};
+    bool result{true};
+    for (const auto& elem : witness.stack) {
+        if (elem.size() > MAX_SCRIPT_ELEMENT_SIZE) {
+            error = SCRIPT_ERR_PUSH_SIZE;
+            result = false;
+        }
+    }
+    if (result) {
+        std::vector<std::vector<unsigned char>> stack{witness.stack};
+        result = EvalScript(stack, exec_script, flags, checker, SigVersion::WITNESS_V0, &error);
+        if (result && stack.size() != 1) {
+            error = SCRIPT_ERR_CLEANSTACK;
+            result = false;
+        } else if (result && stack.back().empty()) { // OP_CHECKSIG pushes an empty vector for false
+            error = SCRIPT_ERR_EVAL_FALSE;
+            result = false;
+        }
+    }
+
+    assert(fast_result == result);
+    assert(fast_error == error);
+}
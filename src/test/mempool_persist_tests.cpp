@@ -0,0 +1,93 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_removal_reason.h>
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <script/sigcache.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(mempool_persist_tests, TestChain100Setup)
+
+/**
+ * Transactions whose inputs the script pre-check cannot find are left to AcceptToMemoryPool, and do
+ * not keep the transactions after them from being pre-checked and loaded. The pre-check itself
+ * stores the signatures it verified in the signature cache.
+ */
+BOOST_AUTO_TEST_CASE(load_mempool_precheck_fallback)
+{
+    CTxMemPool& pool{*Assert(m_node.mempool)};
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    // The pre-check only runs on the script check threads.
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash(coinbaseKey.GetPubKey()))};
+
+    const CTransactionRef parent{MakeTransactionRef(CreateValidMempoolTransaction(
+        {m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}}, /*input_height=*/1, {coinbaseKey},
+        {CTxOut{10 * COIN, spk}, CTxOut{10 * COIN, spk}}, /*submit=*/false))};
+    // Its input is in the same batch, so the pre-check finds it there.
+    const CTransactionRef child{MakeTransactionRef(CreateValidMempoolTransaction(parent, 0, /*input_height=*/101, coinbaseKey, spk, 9 * COIN, /*submit=*/false))};
+    // Its input exists nowhere, so the pre-check skips it.
+    CMutableTransaction missing_input;
+    missing_input.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), 0});
+    missing_input.vin[0].scriptWitness.stack.push_back({1});
+    missing_input.vout.emplace_back(COIN, spk);
+    const CTransactionRef orphan{MakeTransactionRef(missing_input)};
+    const CTransactionRef sibling{MakeTransactionRef(CreateValidMempoolTransaction(parent, 1, /*input_height=*/101, coinbaseKey, spk, 9 * COIN, /*submit=*/false))};
+    // Its input is an immature coinbase output, which AcceptToMemoryPool rejects before it checks any
+    // script, so only the pre-check can have verified its signature.
+    const CTransactionRef immature{MakeTransactionRef(CreateValidMempoolTransaction(
+        m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/2, coinbaseKey, spk, 49 * COIN, /*submit=*/false))};
+
+    // The signature cache entry of the immature coinbase spend, a legacy P2PK input.
+    const CTxOut& immature_spent{m_coinbase_txns[1]->vout[0]};
+    PrecomputedTransactionData immature_txdata;
+    immature_txdata.Init(*immature, {immature_spent});
+    const uint256 immature_sighash{SignatureHash(immature_spent.scriptPubKey, *immature, 0, SIGHASH_ALL, immature_spent.nValue, SigVersion::BASE, &immature_txdata)};
+    std::vector<unsigned char> immature_sig;
+    opcodetype opcode;
+    CScript::const_iterator pc{immature->vin[0].scriptSig.begin()};
+    BOOST_REQUIRE(immature->vin[0].scriptSig.GetOp(pc, opcode, immature_sig));
+    immature_sig.pop_back();
+    SignatureCache& signature_cache{m_node.chainman->m_validation_cache.m_signature_cache};
+    uint256 immature_entry;
+    signature_cache.ComputeEntryECDSA(immature_entry, immature_sighash, immature_sig, coinbaseKey.GetPubKey());
+    BOOST_REQUIRE(!signature_cache.Get(immature_entry, /*erase=*/false));
+
+    const std::vector<CTransactionRef> txs{parent, child, orphan, sibling, immature};
+    const fs::path mempool_dat{m_path_root / "mempool.dat"};
+    {
+        TestMemPoolEntryHelper entry;
+        LOCK2(cs_main, pool.cs);
+        for (const auto& tx : txs) pool.addUnchecked(entry.Fee(1000).FromTx(tx));
+    }
+    BOOST_REQUIRE(node::DumpMempool(pool, mempool_dat));
+    WITH_LOCK(pool.cs, for (const auto& tx : txs) pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED));
+    BOOST_REQUIRE_EQUAL(pool.size(), 0U);
+
+    BOOST_CHECK(node::LoadMempool(pool, mempool_dat, chainstate, {.use_current_time = true}));
+    BOOST_CHECK_EQUAL(pool.size(), 3U);
+    BOOST_CHECK(pool.exists(GenTxid::Txid(parent->GetHash())));
+    BOOST_CHECK(pool.exists(GenTxid::Txid(child->GetHash())));
+    BOOST_CHECK(!pool.exists(GenTxid::Txid(orphan->GetHash())));
+    BOOST_CHECK(pool.exists(GenTxid::Txid(sibling->GetHash())));
+    BOOST_CHECK(!pool.exists(GenTxid::Txid(immature->GetHash())));
+    BOOST_CHECK(signature_cache.Get(immature_entry, /*erase=*/false));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <common/system.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
@@ -804,4 +805,54 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTestsDiamond)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolPooledMemoryTest)
+{
+    TestMemPoolEntryHelper entry;
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    // The resource starts out with one chunk, which DynamicMemoryUsage() does not count while it is empty.
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumAllocatedChunks(), 1U);
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumBytesInUse(), 0U);
+    const size_t usage_empty{pool.DynamicMemoryUsage()};
+
+    CMutableTransaction parent;
+    parent.vin.resize(1);
+    parent.vin[0].scriptSig = CScript() << OP_11;
+    parent.vout.resize(3);
+    for (auto& out : parent.vout) {
+        out.scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        out.nValue = 10 * COIN;
+    }
+    pool.addUnchecked(entry.FromTx(parent));
+    for (uint32_t i = 0; i < parent.vout.size(); ++i) {
+        CMutableTransaction child;
+        child.vin.resize(1);
+        child.vin[0].scriptSig = CScript() << OP_11;
+        child.vin[0].prevout = COutPoint{parent.GetHash(), i};
+        child.vout.resize(1);
+        child.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        child.vout[0].nValue = 9 * COIN;
+        pool.addUnchecked(entry.FromTx(child));
+    }
+    BOOST_CHECK_EQUAL(pool.size(), 4U);
+    BOOST_CHECK_EQUAL(pool.mapNextTx.size(), 4U);
+
+    // The entries and spent outpoints are carved out of the mempool's own pool resource.
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumAllocatedChunks(), 1U);
+    // Only the blocks taken from the chunk count, not the whole chunk.
+    const size_t pool_bytes{pool.m_memory_resource.NumBytesInUse()};
+    BOOST_CHECK(pool_bytes >= 4 * sizeof(CTxMemPool::indexed_transaction_set::final_node_type));
+    BOOST_CHECK(pool_bytes < pool.m_memory_resource.ChunkSizeBytes());
+    BOOST_CHECK(pool.DynamicMemoryUsage() > usage_empty + pool_bytes);
+    BOOST_CHECK(pool.DynamicMemoryUsage() < usage_empty + pool.m_memory_resource.ChunkSizeBytes() / 2);
+
+    // Removing everything keeps the chunk for later entries, and gives back all of the memory in
+    // use, except for the capacity txns_randomized keeps.
+    pool.removeRecursive(CTransaction(parent), REMOVAL_REASON_DUMMY);
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumAllocatedChunks(), 1U);
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumBytesInUse(), 0U);
+    BOOST_CHECK_EQUAL(pool.DynamicMemoryUsage(), usage_empty + memusage::DynamicUsage(pool.txns_randomized));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
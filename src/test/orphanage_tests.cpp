@@ -198,34 +198,34 @@ BOOST_AUTO_TEST_CASE(DoS_mapOrphans)
 
     // Test LimitOrphanTxSize() function, nothing should timeout:
     FastRandomContext rng{/*fDeterministic=*/true};
-    orphanage.LimitOrphans(/*max_orphans=*/expected_num_orphans, rng);
+    orphanage.LimitOrphans(/*max_orphans=*/expected_num_orphans);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), expected_num_orphans);
     expected_num_orphans -= 1;
-    orphanage.LimitOrphans(/*max_orphans=*/expected_num_orphans, rng);
+    orphanage.LimitOrphans(/*max_orphans=*/expected_num_orphans);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), expected_num_orphans);
     assert(expected_num_orphans > 40);
-    orphanage.LimitOrphans(40, rng);
+    orphanage.LimitOrphans(40);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 40);
-    orphanage.LimitOrphans(10, rng);
+    orphanage.LimitOrphans(10);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 10);
-    orphanage.LimitOrphans(0, rng);
+    orphanage.LimitOrphans(0);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 0);
 
     // Add one more orphan, check timeout logic
     auto timeout_tx = MakeTransactionSpending(/*outpoints=*/{}, rng);
     orphanage.AddTx(timeout_tx, 0);
-    orphanage.LimitOrphans(1, rng);
+    orphanage.LimitOrphans(1);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 1);
 
     // One second shy of expiration
     SetMockTime(now + ORPHAN_TX_EXPIRE_TIME - 1s);
-    orphanage.LimitOrphans(1, rng);
+    orphanage.LimitOrphans(1);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 1);
 
     // Jump one more second, orphan should be timed out on limiting
     SetMockTime(now + ORPHAN_TX_EXPIRE_TIME);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 1);
-    orphanage.LimitOrphans(1, rng);
+    orphanage.LimitOrphans(1);
     BOOST_CHECK_EQUAL(orphanage.CountOrphans(), 0);
 }
 
@@ -390,4 +390,71 @@ BOOST_AUTO_TEST_CASE(too_large_orphan_tx)
     BOOST_CHECK(orphanage.AddTx(MakeTransactionRef(tx), 0));
 }
 
+static CTransactionRef MakeBulkedOrphan(int32_t weight, FastRandomContext& det_rand)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(Txid::FromUint256(det_rand.rand256()), 0);
+    BulkTransaction(tx, weight);
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(peer_count_budget)
+{
+    FastRandomContext det_rand{true};
+    TxOrphanage orphanage;
+    const NodeId honest{0};
+    const NodeId attacker{1};
+
+    std::vector<CTransactionRef> honest_orphans;
+    for (int i = 0; i < 3; ++i) {
+        honest_orphans.push_back(MakeTransactionSpending({}, det_rand));
+        BOOST_CHECK(orphanage.AddTx(honest_orphans.back(), honest));
+    }
+
+    // The attacker floods the orphanage. Only its own orphans are evicted, oldest first.
+    std::vector<CTransactionRef> attacker_orphans;
+    for (int i = 0; i < 200; ++i) {
+        attacker_orphans.push_back(MakeTransactionSpending({}, det_rand));
+        BOOST_CHECK(orphanage.AddTx(attacker_orphans.back(), attacker));
+        orphanage.LimitOrphans(/*max_orphans=*/50);
+        BOOST_CHECK(orphanage.Size() <= 50);
+    }
+    for (const auto& tx : honest_orphans) BOOST_CHECK(orphanage.HaveTx(tx->GetWitnessHash()));
+    BOOST_CHECK(orphanage.HaveTx(attacker_orphans.back()->GetWitnessHash()));
+    BOOST_CHECK(!orphanage.HaveTx(attacker_orphans.front()->GetWitnessHash()));
+
+    // Erasing the attacker's orphans leaves the honest peer's.
+    orphanage.EraseForPeer(attacker);
+    BOOST_CHECK_EQUAL(orphanage.Size(), honest_orphans.size());
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(attacker), 0);
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), orphanage.UsageByPeer(honest));
+}
+
+BOOST_AUTO_TEST_CASE(peer_weight_budget)
+{
+    FastRandomContext det_rand{true};
+    TxOrphanage orphanage;
+    const NodeId honest{0};
+    const NodeId attacker{1};
+
+    const auto honest_orphan{MakeBulkedOrphan(50'000, det_rand)};
+    BOOST_CHECK(orphanage.AddTx(honest_orphan, honest));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(honest), 50'000);
+
+    // Few but large orphans from the attacker exceed the weight budget of the two peers.
+    for (int i = 0; i < 10; ++i) {
+        BOOST_CHECK(orphanage.AddTx(MakeBulkedOrphan(MAX_STANDARD_TX_WEIGHT, det_rand), attacker));
+        orphanage.LimitOrphans(/*max_orphans=*/100);
+        BOOST_CHECK(orphanage.TotalOrphanUsage() <= 2 * RESERVED_ORPHAN_WEIGHT_PER_PEER);
+    }
+    BOOST_CHECK(orphanage.HaveTx(honest_orphan->GetWitnessHash()));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(attacker), int64_t{MAX_STANDARD_TX_WEIGHT});
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), orphanage.UsageByPeer(honest) + orphanage.UsageByPeer(attacker));
+
+    // Removing orphans releases their weight.
+    BOOST_CHECK_EQUAL(orphanage.EraseTx(honest_orphan->GetWitnessHash()), 1);
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(honest), 0);
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), orphanage.UsageByPeer(attacker));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
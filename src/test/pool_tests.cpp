@@ -30,6 +30,7 @@ BOOST_AUTO_TEST_CASE(basic_allocating)
     void* block = resource.Allocate(8, 8);
     expected_bytes_available -= 8;
     BOOST_TEST(expected_bytes_available == PoolResourceTester::AvailableMemoryFromChunk(resource));
+    BOOST_TEST(8 == resource.NumBytesInUse());
 
     BOOST_TEST(0 == PoolResourceTester::FreeListSizes(resource)[1]);
     resource.Deallocate(block, 8, 8);
@@ -50,6 +51,7 @@ BOOST_AUTO_TEST_CASE(basic_allocating)
     // can't use resource because alignment is too big, allocate system memory
     b = resource.Allocate(8, 16);
     BOOST_TEST(b != block);
+    BOOST_TEST(0 == resource.NumBytesInUse());
     block = b;
     PoolResourceTester::CheckAllDataAccountedFor(resource);
     BOOST_TEST(1 == PoolResourceTester::FreeListSizes(resource)[1]);
@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <hash.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
 #include <serialize.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -101,6 +103,54 @@ BOOST_AUTO_TEST_CASE(sizes)
     BOOST_CHECK_EQUAL(GetSerializeSize(std::array<uint8_t, 2>{0, 0}), 2U);
 }
 
+//! Declares one byte more than its fields serialize to.
+struct WrongFixedSize {
+    uint32_t n{0};
+    SERIALIZE_METHODS_FIXED_SIZE(WrongFixedSize, obj, 5) { READWRITE(obj.n); }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_size)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000004;
+    header.hashPrevBlock = m_rng.rand256();
+    header.hashMerkleRoot = m_rng.rand256();
+    header.nTime = 1700000000;
+    header.nBits = 0x1703a30c;
+    header.nNonce = 0xdeadbeef;
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 7};
+
+    // The serialization must be the same as serializing the fields one by one.
+    DataStream expected;
+    expected << header.nVersion << header.hashPrevBlock << header.hashMerkleRoot << header.nTime << header.nBits << header.nNonce;
+    expected << outpoint.hash << outpoint.n;
+    DataStream ss;
+    ss << header << outpoint;
+    BOOST_CHECK_EQUAL(ss.size(), CBlockHeader::SERIALIZED_SIZE + COutPoint::SERIALIZED_SIZE);
+    BOOST_CHECK(std::equal(ss.begin(), ss.end(), expected.begin(), expected.end()));
+    BOOST_CHECK_EQUAL(GetSerializeSize(header), CBlockHeader::SERIALIZED_SIZE);
+    BOOST_CHECK_EQUAL(GetSerializeSize(outpoint), COutPoint::SERIALIZED_SIZE);
+
+    CBlockHeader header2;
+    COutPoint outpoint2;
+    ss >> header2 >> outpoint2;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK_EQUAL(header2.GetHash(), header.GetHash());
+    BOOST_CHECK(outpoint2 == outpoint);
+
+    // A truncated object fails to deserialize.
+    DataStream truncated{Span{expected}.first(CBlockHeader::SERIALIZED_SIZE - 1)};
+    BOOST_CHECK_THROW(truncated >> header2, std::ios_base::failure);
+
+    // A SERIALIZED_SIZE that does not match the fields is caught both ways.
+    WrongFixedSize wrong;
+    DataStream wrong_ss;
+    BOOST_CHECK_THROW(wrong_ss << wrong, std::ios_base::failure);
+    BOOST_CHECK(wrong_ss.empty());
+    wrong_ss << uint32_t{1} << uint8_t{2};
+    BOOST_CHECK_THROW(wrong_ss >> wrong, std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_CASE(varints)
 {
     // encode
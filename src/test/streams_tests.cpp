@@ -252,6 +252,28 @@ BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
     }
 }
 
+BOOST_AUTO_TEST_CASE(xor_random)
+{
+    // Compare against a byte by byte reference, for key sizes with and
+    // without the word-at-a-time path, and for unaligned offsets and lengths.
+    FastRandomContext rng{/*fDeterministic=*/true};
+    for (size_t key_size{1}; key_size <= 9; ++key_size) {
+        for (int i{0}; i < 100; ++i) {
+            const auto key{rng.randbytes<std::byte>(key_size)};
+            const auto data{rng.randbytes<std::byte>(rng.randrange(100U))};
+            const size_t key_offset{rng.randrange(20U)};
+
+            auto expected{data};
+            for (size_t j{0}; j < expected.size(); ++j) {
+                expected[j] ^= key[(key_offset + j) % key_size];
+            }
+            auto actual{data};
+            util::Xor(actual, key, key_offset);
+            BOOST_CHECK(actual == expected);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(streams_buffered_file)
 {
     fs::path streams_test_filename = m_args.GetDataDirBase() / "streams_test_tmp";
@@ -567,4 +589,49 @@ BOOST_AUTO_TEST_CASE(streams_hashed)
     BOOST_CHECK_EQUAL(hash_writer.GetHash(), hash_verifier.GetHash());
 }
 
+BOOST_AUTO_TEST_CASE(streams_public_data)
+{
+    static_assert(BufferPool::ClassIndex(1) == 0);
+    static_assert(BufferPool::ClassIndex(BufferPool::MIN_BUFFER_SIZE) == 0);
+    static_assert(BufferPool::ClassIndex(BufferPool::MIN_BUFFER_SIZE + 1) == 1);
+
+    // A small buffer released by a public stream is handed out again to the next one.
+    const std::byte* first_buffer;
+    {
+        DataStream ss{PUBLIC_DATA};
+        ss.reserve(16);
+        ss << uint64_t{1} << uint64_t{2};
+        first_buffer = ss.data();
+    }
+    {
+        DataStream ss{PUBLIC_DATA};
+        ss.reserve(16);
+        ss << uint64_t{3} << uint64_t{4};
+        BOOST_CHECK_EQUAL(ss.data(), first_buffer);
+        uint64_t a, b;
+        ss >> a >> b;
+        BOOST_CHECK_EQUAL(a, 3U);
+        BOOST_CHECK_EQUAL(b, 4U);
+    }
+
+    // Moving or swapping streams keeps each buffer with the allocator it came from.
+    DataStream pub{PUBLIC_DATA};
+    DataStream priv{};
+    pub << uint32_t{5};
+    priv << uint32_t{6};
+    DataStream moved{std::move(pub)};
+    std::swap(moved, priv);
+    uint32_t value;
+    moved >> value;
+    BOOST_CHECK_EQUAL(value, 6U);
+    priv >> value;
+    BOOST_CHECK_EQUAL(value, 5U);
+
+    // Buffers larger than the pooled sizes still work.
+    DataStream large{PUBLIC_DATA};
+    large.resize(BufferPool::MAX_BUFFER_SIZE * 4, std::byte{0x2a});
+    large.resize(1);
+    BOOST_CHECK(large[0] == std::byte{0x2a});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
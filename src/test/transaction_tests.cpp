@@ -422,6 +422,38 @@ BOOST_AUTO_TEST_CASE(basic_transaction_tests)
     BOOST_CHECK_MESSAGE(!CheckTransaction(CTransaction(tx), state) || !state.IsValid(), "Transaction with duplicate txins should be invalid.");
 }
 
+BOOST_AUTO_TEST_CASE(make_transaction_refs)
+{
+    // Enough witness data for MakeTransactionRefs to hash the transactions in several batches.
+    std::vector<CMutableTransaction> txs(100);
+    for (auto& tx : txs) {
+        tx.vin.resize(1 + m_rng.randrange(3));
+        for (auto& txin : tx.vin) {
+            txin.prevout = COutPoint{Txid::FromUint256(m_rng.rand256()), m_rng.rand32()};
+            txin.scriptSig = CScript() << m_rng.randbytes(m_rng.randrange(100));
+            if (m_rng.randbool()) txin.scriptWitness.stack.push_back(m_rng.randbytes(m_rng.randrange(50000)));
+        }
+        tx.vout.resize(m_rng.randrange(3));
+        for (auto& txout : tx.vout) {
+            txout.nValue = m_rng.randrange(MAX_MONEY);
+            txout.scriptPubKey = CScript() << m_rng.randbytes(m_rng.randrange(100));
+        }
+    }
+    std::vector<CTransactionRef> expected;
+    for (const auto& tx : txs) {
+        expected.push_back(MakeTransactionRef(tx));
+    }
+
+    const std::vector<CTransactionRef> refs{MakeTransactionRefs(std::move(txs))};
+    BOOST_REQUIRE_EQUAL(refs.size(), expected.size());
+    for (size_t i = 0; i < refs.size(); ++i) {
+        BOOST_CHECK(*refs[i] == *expected[i]);
+        BOOST_CHECK_EQUAL(refs[i]->GetHash(), expected[i]->GetHash());
+        BOOST_CHECK_EQUAL(refs[i]->GetWitnessHash(), expected[i]->GetWitnessHash());
+        BOOST_CHECK_EQUAL(refs[i]->HasWitness(), expected[i]->HasWitness());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_Get)
 {
     FillableSigningProvider keystore;
@@ -8,6 +8,56 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
+namespace {
+
+/** Two nodes connected to each other, each reconciling with the other. */
+struct ReconcilingPair {
+    static constexpr NodeId INITIATOR_ID{0}; //!< How the responder knows the initiator.
+    static constexpr NodeId RESPONDER_ID{1}; //!< How the initiator knows the responder.
+
+    TxReconciliationTracker initiator{TXRECONCILIATION_VERSION};
+    TxReconciliationTracker responder{TXRECONCILIATION_VERSION};
+
+    ReconcilingPair()
+    {
+        const uint64_t initiator_salt{initiator.PreRegisterPeer(RESPONDER_ID)};
+        const uint64_t responder_salt{responder.PreRegisterPeer(INITIATOR_ID)};
+        BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(RESPONDER_ID, /*is_peer_inbound=*/false, TXRECONCILIATION_VERSION, responder_salt), ReconciliationRegisterResult::SUCCESS);
+        BOOST_REQUIRE_EQUAL(responder.RegisterPeer(INITIATOR_ID, /*is_peer_inbound=*/true, TXRECONCILIATION_VERSION, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+    }
+
+    /** Run the protocol up to the sketch being handled by the initiator. */
+    SketchResult RequestAndHandleSketch()
+    {
+        const auto request{initiator.InitiateReconciliationRequest(RESPONDER_ID, std::chrono::microseconds{0})};
+        BOOST_REQUIRE(request);
+        BOOST_REQUIRE(responder.HandleReconciliationRequest(INITIATOR_ID, request->set_size, request->q));
+        const auto skdata{responder.RespondToReconciliationRequest(INITIATOR_ID)};
+        BOOST_REQUIRE(skdata);
+        const auto result{initiator.HandleSketch(RESPONDER_ID, *skdata)};
+        BOOST_REQUIRE(result);
+        return *result;
+    }
+};
+
+std::vector<Wtxid> RandomWtxids(FastRandomContext& rng, size_t count)
+{
+    std::vector<Wtxid> wtxids;
+    for (size_t i = 0; i < count; ++i) wtxids.push_back(Wtxid::FromUint256(rng.rand256()));
+    std::sort(wtxids.begin(), wtxids.end());
+    return wtxids;
+}
+
+std::vector<Wtxid> Sorted(std::vector<Wtxid> wtxids)
+{
+    std::sort(wtxids.begin(), wtxids.end());
+    return wtxids;
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
@@ -25,24 +75,24 @@ BOOST_AUTO_TEST_CASE(RegisterPeerTest)
 
     // Valid registration (inbound and outbound peers).
     BOOST_REQUIRE(!tracker.IsPeerRegistered(0));
-    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, 1, salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, TXRECONCILIATION_VERSION, salt), ReconciliationRegisterResult::SUCCESS);
     BOOST_CHECK(tracker.IsPeerRegistered(0));
     BOOST_REQUIRE(!tracker.IsPeerRegistered(1));
     tracker.PreRegisterPeer(1);
-    BOOST_REQUIRE(tracker.RegisterPeer(1, false, 1, salt) == ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE(tracker.RegisterPeer(1, false, TXRECONCILIATION_VERSION, salt) == ReconciliationRegisterResult::SUCCESS);
     BOOST_CHECK(tracker.IsPeerRegistered(1));
 
     // Reconciliation version is higher than ours, should be able to register.
     BOOST_REQUIRE(!tracker.IsPeerRegistered(2));
     tracker.PreRegisterPeer(2);
-    BOOST_REQUIRE(tracker.RegisterPeer(2, true, 2, salt) == ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE(tracker.RegisterPeer(2, true, TXRECONCILIATION_VERSION + 1, salt) == ReconciliationRegisterResult::SUCCESS);
     BOOST_CHECK(tracker.IsPeerRegistered(2));
 
     // Try registering for the second time.
-    BOOST_REQUIRE(tracker.RegisterPeer(1, false, 1, salt) == ReconciliationRegisterResult::ALREADY_REGISTERED);
+    BOOST_REQUIRE(tracker.RegisterPeer(1, false, TXRECONCILIATION_VERSION, salt) == ReconciliationRegisterResult::ALREADY_REGISTERED);
 
     // Do not register if there were no pre-registration for the peer.
-    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(100, true, 1, salt), ReconciliationRegisterResult::NOT_FOUND);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(100, true, TXRECONCILIATION_VERSION, salt), ReconciliationRegisterResult::NOT_FOUND);
     BOOST_CHECK(!tracker.IsPeerRegistered(100));
 }
 
@@ -54,12 +104,12 @@ BOOST_AUTO_TEST_CASE(ForgetPeerTest)
     // Removing peer after pre-registring works and does not let to register the peer.
     tracker.PreRegisterPeer(peer_id0);
     tracker.ForgetPeer(peer_id0);
-    BOOST_CHECK_EQUAL(tracker.RegisterPeer(peer_id0, true, 1, 1), ReconciliationRegisterResult::NOT_FOUND);
+    BOOST_CHECK_EQUAL(tracker.RegisterPeer(peer_id0, true, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::NOT_FOUND);
 
     // Removing peer after it is registered works.
     tracker.PreRegisterPeer(peer_id0);
     BOOST_REQUIRE(!tracker.IsPeerRegistered(peer_id0));
-    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, true, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
     BOOST_CHECK(tracker.IsPeerRegistered(peer_id0));
     tracker.ForgetPeer(peer_id0);
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
@@ -74,11 +124,227 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     tracker.PreRegisterPeer(peer_id0);
     BOOST_REQUIRE(!tracker.IsPeerRegistered(peer_id0));
 
-    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id0, true, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
     BOOST_CHECK(tracker.IsPeerRegistered(peer_id0));
 
     tracker.ForgetPeer(peer_id0);
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(AddToSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Transactions can't be added for peers which are not registered.
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(0, wtxid));
+
+    // The set is bounded: beyond the limit, transactions must be announced directly.
+    size_t added{0};
+    while (tracker.AddToSet(0, Wtxid::FromUint256(m_rng.rand256()))) ++added;
+    BOOST_CHECK(added > 0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationSuccessTest)
+{
+    ReconcilingPair pair;
+    const auto shared{RandomWtxids(m_rng, 50)};
+    const auto initiator_only{RandomWtxids(m_rng, 3)};
+    const auto responder_only{RandomWtxids(m_rng, 2)};
+    for (const auto& wtxid : shared) {
+        BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+        BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, wtxid));
+    }
+    for (const auto& wtxid : initiator_only) BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, wtxid));
+
+    const SketchResult result{pair.RequestAndHandleSketch()};
+    BOOST_CHECK(!result.request_extension);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK(Sorted(result.txs_to_announce) == initiator_only);
+    BOOST_CHECK_EQUAL(result.txs_to_request.size(), responder_only.size());
+
+    const auto txs_to_announce{pair.responder.HandleReconciliationDifference(ReconcilingPair::INITIATOR_ID, true, result.txs_to_request)};
+    BOOST_REQUIRE(txs_to_announce);
+    BOOST_CHECK(Sorted(*txs_to_announce) == responder_only);
+
+    // Both sets were consumed by the reconciliation, so the next one starts from scratch.
+    BOOST_CHECK(!pair.initiator.TryRemovingFromSet(ReconcilingPair::RESPONDER_ID, shared[0]));
+    BOOST_CHECK(!pair.responder.TryRemovingFromSet(ReconcilingPair::INITIATOR_ID, shared[0]));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationExtensionTest)
+{
+    // Equal set sizes lead to a small estimate of the difference, which is then exceeded.
+    ReconcilingPair pair;
+    const auto shared{RandomWtxids(m_rng, 5)};
+    const auto initiator_only{RandomWtxids(m_rng, 3)};
+    const auto responder_only{RandomWtxids(m_rng, 3)};
+    for (const auto& wtxid : shared) {
+        BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+        BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, wtxid));
+    }
+    for (const auto& wtxid : initiator_only) BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, wtxid));
+
+    BOOST_REQUIRE(pair.RequestAndHandleSketch().request_extension);
+
+    // Transactions arriving meanwhile are left for the next reconciliation.
+    const Wtxid late{Wtxid::FromUint256(m_rng.rand256())};
+    BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, late));
+    // A transaction the initiator was missing but has received meanwhile is not requested.
+    BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, responder_only[0]));
+
+    const auto ext_skdata{pair.responder.HandleSketchExtensionRequest(ReconcilingPair::INITIATOR_ID)};
+    BOOST_REQUIRE(ext_skdata);
+    const auto result{pair.initiator.HandleSketch(ReconcilingPair::RESPONDER_ID, *ext_skdata)};
+    BOOST_REQUIRE(result);
+    BOOST_CHECK(result->success);
+    BOOST_CHECK(Sorted(result->txs_to_announce) == initiator_only);
+
+    const auto txs_to_announce{pair.responder.HandleReconciliationDifference(ReconcilingPair::INITIATOR_ID, true, result->txs_to_request)};
+    BOOST_REQUIRE(txs_to_announce);
+    BOOST_CHECK(Sorted(*txs_to_announce) == std::vector(responder_only.begin() + 1, responder_only.end()));
+    BOOST_CHECK(pair.responder.TryRemovingFromSet(ReconcilingPair::INITIATOR_ID, late));
+    BOOST_CHECK(!pair.initiator.TryRemovingFromSet(ReconcilingPair::RESPONDER_ID, responder_only[0]));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationFailureTest)
+{
+    // Disjoint sets of equal size: even the extended sketch is too small.
+    ReconcilingPair pair;
+    const auto initiator_only{RandomWtxids(m_rng, 20)};
+    const auto responder_only{RandomWtxids(m_rng, 20)};
+    for (const auto& wtxid : initiator_only) BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_REQUIRE(pair.responder.AddToSet(ReconcilingPair::INITIATOR_ID, wtxid));
+
+    BOOST_REQUIRE(pair.RequestAndHandleSketch().request_extension);
+    const auto ext_skdata{pair.responder.HandleSketchExtensionRequest(ReconcilingPair::INITIATOR_ID)};
+    BOOST_REQUIRE(ext_skdata);
+    const auto result{pair.initiator.HandleSketch(ReconcilingPair::RESPONDER_ID, *ext_skdata)};
+    BOOST_REQUIRE(result);
+
+    // On failure, both sides announce their whole set.
+    BOOST_CHECK(!result->success);
+    BOOST_CHECK(Sorted(result->txs_to_announce) == initiator_only);
+    const auto txs_to_announce{pair.responder.HandleReconciliationDifference(ReconcilingPair::INITIATOR_ID, false, {})};
+    BOOST_REQUIRE(txs_to_announce);
+    BOOST_CHECK(Sorted(*txs_to_announce) == responder_only);
+}
+
+BOOST_AUTO_TEST_CASE(ProtocolViolationTest)
+{
+    ReconcilingPair pair;
+
+    // Only the initiator may request, and only the responder may send sketches.
+    BOOST_CHECK(!pair.initiator.HandleReconciliationRequest(ReconcilingPair::RESPONDER_ID, 0, 0));
+    BOOST_CHECK(!pair.responder.HandleSketch(ReconcilingPair::INITIATOR_ID, {}));
+
+    // Messages out of sequence.
+    BOOST_CHECK(!pair.initiator.HandleSketch(ReconcilingPair::RESPONDER_ID, {}));
+    BOOST_CHECK(!pair.responder.HandleSketchExtensionRequest(ReconcilingPair::INITIATOR_ID));
+    BOOST_CHECK(!pair.responder.HandleReconciliationDifference(ReconcilingPair::INITIATOR_ID, true, {}));
+    BOOST_CHECK(pair.responder.HandleReconciliationRequest(ReconcilingPair::INITIATOR_ID, 0, 0));
+    BOOST_CHECK(!pair.responder.HandleReconciliationRequest(ReconcilingPair::INITIATOR_ID, 0, 0));
+
+    // Malformed sketch.
+    BOOST_REQUIRE(pair.initiator.InitiateReconciliationRequest(ReconcilingPair::RESPONDER_ID, std::chrono::microseconds{0}));
+    BOOST_CHECK(!pair.initiator.HandleSketch(ReconcilingPair::RESPONDER_ID, std::vector<uint8_t>(3)));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationSchedulingTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    for (NodeId peer_id : {0, 1}) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/false, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+    tracker.PreRegisterPeer(2);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(2, /*is_peer_inbound=*/true, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
+
+    // We never initiate reconciliations with inbound peers.
+    std::chrono::microseconds now{1s};
+    BOOST_CHECK(!tracker.InitiateReconciliationRequest(2, now));
+
+    // Outbound peers take turns, evenly spaced over RECON_REQUEST_INTERVAL.
+    BOOST_CHECK(!tracker.InitiateReconciliationRequest(1, now));
+    BOOST_CHECK(tracker.InitiateReconciliationRequest(0, now));
+    BOOST_CHECK(!tracker.InitiateReconciliationRequest(1, now));
+    now += RECON_REQUEST_INTERVAL / 2;
+    BOOST_CHECK(tracker.InitiateReconciliationRequest(1, now));
+
+    // A turn is skipped while the previous reconciliation with the peer is in flight.
+    now += RECON_REQUEST_INTERVAL / 2;
+    BOOST_CHECK(!tracker.InitiateReconciliationRequest(0, now));
+    // An empty sketch concludes it.
+    BOOST_REQUIRE(tracker.HandleSketch(0, {}));
+
+    // Forgotten peers leave the rotation.
+    tracker.ForgetPeer(1);
+    now += RECON_REQUEST_INTERVAL / 2;
+    BOOST_CHECK(tracker.InitiateReconciliationRequest(0, now));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationTimeoutTest)
+{
+    ReconcilingPair pair;
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto wtxids{RandomWtxids(rng, 3)};
+    for (const Wtxid& wtxid : wtxids) BOOST_REQUIRE(pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxid));
+
+    // Nothing to expire until a reconciliation is in flight for long enough.
+    std::chrono::microseconds now{1s};
+    BOOST_CHECK(!pair.initiator.ExpireReconciliation(ReconcilingPair::RESPONDER_ID, now));
+    BOOST_REQUIRE(pair.initiator.InitiateReconciliationRequest(ReconcilingPair::RESPONDER_ID, now));
+    now += RECON_RESPONSE_TIMEOUT - 1s;
+    BOOST_CHECK(!pair.initiator.ExpireReconciliation(ReconcilingPair::RESPONDER_ID, now));
+
+    // The peer never answered, e.g. because it ignores reqrecon: announce the whole set, and stop
+    // reconciling with it.
+    now += 1s;
+    const auto txs_to_announce{pair.initiator.ExpireReconciliation(ReconcilingPair::RESPONDER_ID, now)};
+    BOOST_REQUIRE(txs_to_announce);
+    BOOST_CHECK(Sorted(*txs_to_announce) == wtxids);
+    BOOST_CHECK(!pair.initiator.IsPeerRegistered(ReconcilingPair::RESPONDER_ID));
+    BOOST_CHECK(!pair.initiator.AddToSet(ReconcilingPair::RESPONDER_ID, wtxids[0]));
+
+    // Responders do not time out.
+    BOOST_CHECK(!pair.responder.ExpireReconciliation(ReconcilingPair::INITIATOR_ID, now + 1h));
+}
+
+BOOST_AUTO_TEST_CASE(FanoutTargetsTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    for (NodeId peer_id = 0; peer_id < 30; ++peer_id) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/peer_id >= 5, TXRECONCILIATION_VERSION, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+    // One outbound peer, and 10% of the 25 inbound peers: 2 or 3, depending on the transaction.
+    size_t rounded_up{0};
+    for (int i = 0; i < 200; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        const auto targets{tracker.GetFanoutTargets(wtxid, /*inbounds_flooding=*/0, /*outbounds_flooding=*/0)};
+        BOOST_CHECK(targets.size() == 1 + 2 || targets.size() == 1 + 3);
+        BOOST_CHECK_EQUAL(std::count_if(targets.begin(), targets.end(), [](NodeId id) { return id < 5; }), 1);
+        BOOST_CHECK(tracker.GetFanoutTargets(wtxid, 0, 0) == targets);
+        rounded_up += targets.size() == 1 + 3;
+    }
+    BOOST_CHECK(rounded_up > 50 && rounded_up < 150);
+
+    // Peers we flood to anyway count towards the targets.
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+    const auto targets{tracker.GetFanoutTargets(wtxid, /*inbounds_flooding=*/1, /*outbounds_flooding=*/1)};
+    BOOST_CHECK(targets.size() == 1 || targets.size() == 2);
+    BOOST_CHECK(std::all_of(targets.begin(), targets.end(), [](NodeId id) { return id >= 5; }));
+    BOOST_CHECK(tracker.GetFanoutTargets(wtxid, /*inbounds_flooding=*/10, /*outbounds_flooding=*/8).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
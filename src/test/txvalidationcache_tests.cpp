@@ -15,6 +15,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 struct Dersig100Setup : public TestChain100Setup {
     Dersig100Setup()
         : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-testactivationheight=dersig@102"}}} {}
@@ -24,7 +26,8 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
                        ValidationCache& validation_cache,
-                       std::vector<CScriptCheck>* pvChecks) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+                       std::vector<CScriptCheck>* pvChecks,
+                       DeferredTxDataInit* txdata_init = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 BOOST_AUTO_TEST_SUITE(txvalidationcache_tests)
 
@@ -160,6 +163,15 @@ static void ValidateCheckInputsForAllFlags(const CTransaction &tx, uint32_t fail
             std::vector<CScriptCheck> scriptchecks;
             BOOST_CHECK(CheckInputScripts(tx, state, &active_coins_tip, test_flags, true, add_to_cache, txdata, validation_cache, &scriptchecks));
             BOOST_CHECK_EQUAL(scriptchecks.size(), tx.vin.size());
+
+            // Leaving the precomputed data to be initialized by the first
+            // check to run must give the same result as checking inline.
+            PrecomputedTransactionData deferred_txdata;
+            DeferredTxDataInit txdata_init;
+            std::vector<CScriptCheck> deferred_checks;
+            BOOST_CHECK(CheckInputScripts(tx, state, &active_coins_tip, test_flags, true, add_to_cache, deferred_txdata, validation_cache, &deferred_checks, &txdata_init));
+            BOOST_CHECK_EQUAL(deferred_checks.size(), tx.vin.size());
+            BOOST_CHECK_EQUAL(std::all_of(deferred_checks.begin(), deferred_checks.end(), [](CScriptCheck& check) { return check(); }), ret);
         }
     }
 }
@@ -70,6 +70,7 @@ public:
      * * All data in the freelists must come from the chunks
      * * Memory doesn't overlap
      * * Each byte in the chunks can be accounted for in either the freelist or as available bytes.
+     * * No bytes are counted as in use anymore.
      */
     template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
     static void CheckAllDataAccountedFor(const PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& resource)
@@ -123,6 +124,9 @@ public:
         ++chunk_it;
         assert(chunk_it == chunks.end());
         assert(chunk_size_remaining == 0);
+
+        // no block may be counted as in use anymore
+        assert(resource.NumBytesInUse() == 0);
     }
 };
 
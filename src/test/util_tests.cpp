@@ -238,6 +238,11 @@ BOOST_AUTO_TEST_CASE(util_HexStr)
     BOOST_CHECK_EQUAL(HexStr(Span{HEX_PARSE_OUTPUT}.last(0)), "");
     BOOST_CHECK_EQUAL(HexStr(Span{HEX_PARSE_OUTPUT}.first(0)), "");
 
+    // Every length, so that both the vectorized blocks and the remaining tail are covered.
+    for (size_t len{0}; len <= std::size(HEX_PARSE_OUTPUT); ++len) {
+        BOOST_CHECK_EQUAL(HexStr(Span{HEX_PARSE_OUTPUT}.first(len)), std::string_view{HEX_PARSE_INPUT}.substr(0, 2 * len));
+    }
+
     {
         constexpr std::string_view out_exp{"04678afdb0"};
         constexpr std::span in_s{HEX_PARSE_OUTPUT, out_exp.size() / 2};
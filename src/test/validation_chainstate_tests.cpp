@@ -2,11 +2,17 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 //
+#include <addresstype.h>
 #include <chainparams.h>
+#include <consensus/amount.h>
 #include <consensus/validation.h>
+#include <kernel/coinstats.h>
 #include <node/kernel_notifications.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
 #include <random.h>
 #include <rpc/blockchain.h>
+#include <script/script.h>
 #include <sync.h>
 #include <test/util/chainstate.h>
 #include <test/util/coins.h>
@@ -142,4 +148,68 @@ BOOST_FIXTURE_TEST_CASE(chainstate_update_tip, TestChain100Setup)
     BOOST_CHECK_EQUAL(curr_tip, m_node.notifications->m_tip_block);
 }
 
+//! Test that a reorg disconnecting several blocks, whose block and undo data
+//! are read ahead of DisconnectTip, restores the UTXO set of the chain it
+//! reorgs to, and that reorging back restores the original one.
+BOOST_FIXTURE_TEST_CASE(chainstate_deep_reorg_utxo_set, TestChain100Setup)
+{
+    constexpr int REORG_DEPTH{10};
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+    const auto utxo_set_hash{[&] {
+        LOCK(::cs_main);
+        chainstate.ForceFlushStateToDisk();
+        return Assert(kernel::ComputeUTXOStats(kernel::CoinStatsHashType::HASH_SERIALIZED, &chainstate.CoinsDB(), chainman.m_blockman))->hashSerialized;
+    }};
+    const uint256 base_utxos{utxo_set_hash()};
+    const int base_height{WITH_LOCK(::cs_main, return chainstate.m_chain.Height())};
+
+    // The chain reorged to: one block longer than the chain it replaces, and
+    // invalidated while that one is built.
+    uint256 other_first_hash;
+    for (int i = 0; i <= REORG_DEPTH; ++i) {
+        const CBlock block{CreateAndProcessBlock({}, CScript() << OP_TRUE)};
+        if (i == 0) other_first_hash = block.GetHash();
+    }
+    const uint256 other_utxos{utxo_set_hash()};
+    const uint256 other_tip{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    CBlockIndex* other_first{WITH_LOCK(::cs_main, return chainman.m_blockman.LookupBlockIndex(other_first_hash))};
+    BlockValidationState state;
+    BOOST_REQUIRE(chainstate.InvalidateBlock(state, other_first));
+    BOOST_CHECK_EQUAL(utxo_set_hash(), base_utxos);
+
+    // The chain reorged from: each block spends a coinbase output and the
+    // output of the transaction in the block before it, so that disconnecting
+    // it restores both from the undo data.
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash(coinbaseKey.GetPubKey()))};
+    CTransactionRef prev_tx;
+    for (int i = 0; i < REORG_DEPTH; ++i) {
+        const int height{base_height + 1 + i};
+        std::vector<CMutableTransaction> txs;
+        txs.push_back(CreateValidMempoolTransaction(m_coinbase_txns[i], /*input_vout=*/0, /*input_height=*/i + 1, coinbaseKey, spk, 49 * COIN, /*submit=*/false));
+        if (prev_tx) {
+            txs.push_back(CreateValidMempoolTransaction(prev_tx, /*input_vout=*/0, /*input_height=*/height - 1, coinbaseKey, spk, prev_tx->vout[0].nValue - COIN, /*submit=*/false));
+        }
+        prev_tx = MakeTransactionRef(txs.back());
+        CreateAndProcessBlock(txs, spk);
+        BOOST_REQUIRE_EQUAL(WITH_LOCK(::cs_main, return chainstate.m_chain.Height()), height);
+    }
+    const uint256 tip_utxos{utxo_set_hash()};
+    const uint256 tip{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    BOOST_CHECK(tip_utxos != base_utxos);
+
+    // Reconsidering the longer chain disconnects all REORG_DEPTH blocks in one
+    // ActivateBestChainStep, through the prefetcher.
+    WITH_LOCK(::cs_main, chainstate.ResetBlockFailureFlags(other_first));
+    BOOST_REQUIRE(chainstate.ActivateBestChain(state));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash()), other_tip);
+    BOOST_CHECK_EQUAL(utxo_set_hash(), other_utxos);
+
+    // Invalidating it again reorgs back to the chain with the spends.
+    BOOST_REQUIRE(chainstate.InvalidateBlock(state, other_first));
+    BOOST_REQUIRE(chainstate.ActivateBestChain(state));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash()), tip);
+    BOOST_CHECK_EQUAL(utxo_set_hash(), tip_utxos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
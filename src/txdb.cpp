@@ -17,7 +17,9 @@
 #include <cassert>
 #include <cstdlib>
 #include <iterator>
+#include <optional>
 #include <utility>
+#include <vector>
 
 static constexpr uint8_t DB_COIN{'C'};
 static constexpr uint8_t DB_BEST_BLOCK{'B'};
@@ -160,8 +162,8 @@ class CCoinsViewDBCursor: public CCoinsViewCursor
 public:
     // Prefer using CCoinsViewDB::Cursor() since we want to perform some
     // cache warmup on instantiation.
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn, std::optional<Txid> end = std::nullopt):
+        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn), m_end(end) {}
     ~CCoinsViewDBCursor() = default;
 
     bool GetKey(COutPoint &key) const override;
@@ -173,6 +175,11 @@ public:
 private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! If set, the cursor stops before the first coin whose txid is not lower.
+    std::optional<Txid> m_end;
+
+    //! Cache the key of the current record.
+    void LoadKey();
 
     friend class CCoinsViewDB;
 };
@@ -186,16 +193,40 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
-    } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
-    }
+    i->LoadKey();
     return i;
 }
 
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewDB::PartitionedCursors(size_t num_partitions) const
+{
+    assert(num_partitions > 0 && num_partitions <= 0x10000);
+
+    // Txids are uniformly distributed, so splitting the key space on their
+    // first two bytes yields partitions of roughly equal size.
+    const auto partition_start{[&](size_t i) {
+        const uint32_t prefix = i * 0x10000 / num_partitions;
+        uint256 txid;
+        txid.begin()[0] = prefix >> 8;
+        txid.begin()[1] = prefix & 0xff;
+        return COutPoint{Txid::FromUint256(txid), 0};
+    }};
+
+    const uint256 best_block{GetBestBlock()};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    cursors.reserve(num_partitions);
+    for (size_t i = 0; i < num_partitions; ++i) {
+        std::optional<Txid> end;
+        if (i + 1 < num_partitions) end = partition_start(i + 1).hash;
+        auto cursor = std::make_unique<CCoinsViewDBCursor>(
+            const_cast<CDBWrapper&>(*m_db).NewIterator(), best_block, end);
+        const COutPoint start{partition_start(i)};
+        cursor->pcursor->Seek(CoinEntry(&start));
+        cursor->LoadKey();
+        cursors.push_back(std::move(cursor));
+    }
+    return cursors;
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
@@ -219,8 +250,13 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
+    LoadKey();
+}
+
+void CCoinsViewDBCursor::LoadKey()
+{
     CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || (m_end && !(keyTmp.second.hash < *m_end))) {
         keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
     } else {
         keyTmp.first = entry.key;
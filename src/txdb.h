@@ -37,6 +37,17 @@ static const int64_t nMaxTxIndexCache = 1024;
 static const int64_t max_filter_index_cache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! -dbmaxfilesize default (bytes): the chainstate is large enough for bigger
+//! table files to mean far fewer files and fewer, larger compactions
+static const size_t nDefaultCoinsDBMaxFileSize = 32 << 20;
+
+//! LevelDB settings of the chainstate, which sees random point lookups, many
+//! of them for coins that do not exist.
+static constexpr DBOptions COINS_DB_OPTIONS{.max_file_size = nDefaultCoinsDBMaxFileSize};
+//! LevelDB settings of the block index (blocks/index). It is read by iterating
+//! over all of it at startup, so it uses larger blocks, and its lookups are for
+//! keys that exist, which a bloom filter cannot skip.
+static constexpr DBOptions BLOCK_TREE_DB_OPTIONS{.bloom_filter_bits = 0, .block_size = 16 << 10};
 
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
@@ -64,6 +75,14 @@ public:
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
 
+    /**
+     * Split the coins into num_partitions disjoint ranges of txids and return
+     * a cursor over each, in key order. All cursors iterate over the state of
+     * the database at the time of this call, as long as it is not written to
+     * concurrently (hold cs_main).
+     */
+    std::vector<std::unique_ptr<CCoinsViewCursor>> PartitionedCursors(size_t num_partitions) const;
+
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
     size_t EstimateSize() const override;
@@ -71,6 +90,9 @@ public:
     //! Dynamically alter the underlying leveldb cache size.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    //! Compact the underlying leveldb database.
+    void CompactFull() EXCLUSIVE_LOCKS_REQUIRED(cs_main) { m_db->CompactFull(); }
+
     //! @returns filesystem path to on-disk storage or std::nullopt if in memory.
     std::optional<fs::path> StoragePath() { return m_db->StoragePath(); }
 };
@@ -1027,8 +1027,20 @@ void CCoinsViewMemPool::Reset()
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 15 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + cachedInnerUsage;
+    // The nodes of mapTx and mapNextTx are carved out of the chunks of m_memory_resource without any
+    // malloc overhead. Count the bytes they take, plus the malloc overhead and std::list node (see
+    // memusage::DynamicUsage() for the pooled CCoinsMap) of as many chunks as they fill. Blocks given
+    // back by removed entries are not counted: they are reused by the next entries, and counting them
+    // would leave TrimToSize() unable to get below a limit after a spike.
+    const size_t chunk_size{m_memory_resource.ChunkSizeBytes()};
+    const size_t pool_bytes{m_memory_resource.NumBytesInUse()};
+    const size_t chunks_in_use{(pool_bytes + chunk_size - 1) / chunk_size};
+    const size_t chunk_overhead{memusage::MallocUsage(chunk_size) - chunk_size + memusage::MallocUsage(sizeof(void*) * 3)};
+    const size_t usage_pool{pool_bytes + chunk_overhead * chunks_in_use};
+    // The bucket arrays of the two hashed indices are too large for the pool and come from the heap.
+    const size_t usage_buckets{memusage::MallocUsage(sizeof(void*) * mapTx.get<0>().bucket_count()) +
+                               memusage::MallocUsage(sizeof(void*) * mapTx.get<index_by_wtxid>().bucket_count())};
+    return usage_pool + usage_buckets + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + cachedInnerUsage;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked) {
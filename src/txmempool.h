@@ -17,6 +17,7 @@
 #include <policy/feerate.h>
 #include <policy/packages.h>
 #include <primitives/transaction.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <util/epochguard.h>
 #include <util/hasher.h>
@@ -358,9 +359,17 @@ public:
             >
         >
         {};
+    /**
+     * Largest node allocated from m_memory_resource: an entry plus the hooks of the five mapTx
+     * indices, which take at most 16 pointers.
+     */
+    static constexpr size_t MAPTX_NODE_SIZE_BYTES{sizeof(CTxMemPoolEntry) + 16 * sizeof(void*)};
+    using MemoryResource = PoolResource<MAPTX_NODE_SIZE_BYTES, alignof(CTxMemPoolEntry)>;
+
     typedef boost::multi_index_container<
         CTxMemPoolEntry,
-        CTxMemPoolEntry_Indices
+        CTxMemPoolEntry_Indices,
+        PoolAllocator<CTxMemPoolEntry, MAPTX_NODE_SIZE_BYTES, alignof(CTxMemPoolEntry)>
     > indexed_transaction_set;
 
     /**
@@ -388,7 +397,14 @@ public:
      * the mempool is consistent with the new chain tip and fully populated.
      */
     mutable RecursiveMutex cs;
-    indexed_transaction_set mapTx GUARDED_BY(cs);
+    /**
+     * Backing memory for the nodes of mapTx and mapNextTx. Carving them out of large chunks rather
+     * than allocating each one separately avoids per-allocation overhead and heap fragmentation, so
+     * that DynamicMemoryUsage() stays close to the memory actually used. Only accessed through those
+     * containers, and must be declared before them.
+     */
+    MemoryResource m_memory_resource{};
+    indexed_transaction_set mapTx GUARDED_BY(cs){indexed_transaction_set::ctor_args_list{}, &m_memory_resource};
 
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<CTransactionRef> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx, in random order
@@ -431,7 +447,7 @@ private:
                                                               ) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
 public:
-    indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
+    indirectmap<COutPoint, const CTransaction*, PoolAllocator<std::pair<const COutPoint* const, const CTransaction*>, MAPTX_NODE_SIZE_BYTES, alignof(CTxMemPoolEntry)>> mapNextTx GUARDED_BY(cs){&m_memory_resource};
     std::map<uint256, CAmount> mapDeltas GUARDED_BY(cs);
 
     using Options = kernel::MemPoolOptions;
@@ -687,6 +703,10 @@ public:
     std::vector<CTxMemPoolEntryRef> entryAll() const EXCLUSIVE_LOCKS_REQUIRED(cs);
     std::vector<TxMempoolInfo> infoAll() const;
 
+    /**
+     * Memory used by the mempool, which TrimToSize() limits. The entries' share of the pool chunks is
+     * counted as the blocks they take, with the overhead of the chunks they fill.
+     */
     size_t DynamicMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
@@ -10,6 +10,7 @@
 #include <primitives/transaction.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <cassert>
 
 bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
@@ -24,8 +25,7 @@ bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
     // large transaction with a missing parent then we assume
     // it will rebroadcast it later, after the parent transaction(s)
     // have been mined or received.
-    // 100 orphans, each of which is at most 100,000 bytes big is
-    // at most 10 megabytes of orphans and somewhat more byprev index (in the worst case):
+    // The orphanage is also limited in total weight by LimitOrphans.
     unsigned int sz = GetTransactionWeight(*tx);
     if (sz > MAX_STANDARD_TX_WEIGHT)
     {
@@ -33,12 +33,15 @@ bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
         return false;
     }
 
-    auto ret = m_orphans.emplace(wtxid, OrphanTx{{tx, peer, Now<NodeSeconds>() + ORPHAN_TX_EXPIRE_TIME}, m_orphan_list.size()});
+    auto ret = m_orphans.emplace(wtxid, OrphanTx{{tx, peer, Now<NodeSeconds>() + ORPHAN_TX_EXPIRE_TIME}, m_next_sequence++, sz});
     assert(ret.second);
-    m_orphan_list.push_back(ret.first);
     for (const CTxIn& txin : tx->vin) {
         m_outpoint_to_orphan_it[txin.prevout].insert(ret.first);
     }
+    auto& peer_info = m_peer_orphanage_info[peer];
+    peer_info.orphans_by_age.emplace(ret.first->second.sequence, ret.first);
+    peer_info.total_usage += sz;
+    m_total_orphan_usage += sz;
 
     LogDebug(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u outsz %u)\n", hash.ToString(), wtxid.ToString(), sz,
              m_orphans.size(), m_outpoint_to_orphan_it.size());
@@ -60,21 +63,18 @@ int TxOrphanage::EraseTx(const Wtxid& wtxid)
             m_outpoint_to_orphan_it.erase(itPrev);
     }
 
-    size_t old_pos = it->second.list_pos;
-    assert(m_orphan_list[old_pos] == it);
-    if (old_pos + 1 != m_orphan_list.size()) {
-        // Unless we're deleting the last entry in m_orphan_list, move the last
-        // entry to the position we're deleting.
-        auto it_last = m_orphan_list.back();
-        m_orphan_list[old_pos] = it_last;
-        it_last->second.list_pos = old_pos;
-    }
+    auto peer_it = m_peer_orphanage_info.find(it->second.fromPeer);
+    assert(peer_it != m_peer_orphanage_info.end());
+    peer_it->second.orphans_by_age.erase(it->second.sequence);
+    peer_it->second.total_usage -= it->second.weight;
+    if (peer_it->second.orphans_by_age.empty()) m_peer_orphanage_info.erase(peer_it);
+    m_total_orphan_usage -= it->second.weight;
+
     const auto& txid = it->second.tx->GetHash();
     // Time spent in orphanage = difference between current and entry time.
     // Entry time is equal to ORPHAN_TX_EXPIRE_TIME earlier than entry's expiry.
     LogDebug(BCLog::TXPACKAGES, "   removed orphan tx %s (wtxid=%s) after %ds\n", txid.ToString(), wtxid.ToString(),
              Ticks<std::chrono::seconds>(NodeClock::now() + ORPHAN_TX_EXPIRE_TIME - it->second.nTimeExpire));
-    m_orphan_list.pop_back();
 
     m_orphans.erase(it);
     return 1;
@@ -84,20 +84,23 @@ void TxOrphanage::EraseForPeer(NodeId peer)
 {
     m_peer_work_set.erase(peer);
 
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it == m_peer_orphanage_info.end()) return;
+
+    // Collect the wtxids first, as erasing the peer's last orphan also erases its entry.
+    std::vector<Wtxid> wtxids;
+    wtxids.reserve(peer_it->second.orphans_by_age.size());
+    for (const auto& [_, orphan_it] : peer_it->second.orphans_by_age) {
+        wtxids.push_back(orphan_it->first);
+    }
     int nErased = 0;
-    std::map<Wtxid, OrphanTx>::iterator iter = m_orphans.begin();
-    while (iter != m_orphans.end())
-    {
-        // increment to avoid iterator becoming invalid after erasure
-        const auto& [wtxid, orphan] = *iter++;
-        if (orphan.fromPeer == peer) {
-            nErased += EraseTx(wtxid);
-        }
+    for (const auto& wtxid : wtxids) {
+        nErased += EraseTx(wtxid);
     }
     if (nErased > 0) LogDebug(BCLog::TXPACKAGES, "Erased %d orphan transaction(s) from peer=%d\n", nErased, peer);
 }
 
-void TxOrphanage::LimitOrphans(unsigned int max_orphans, FastRandomContext& rng)
+void TxOrphanage::LimitOrphans(unsigned int max_orphans)
 {
     unsigned int nEvicted = 0;
     auto nNow{Now<NodeSeconds>()};
@@ -119,11 +122,20 @@ void TxOrphanage::LimitOrphans(unsigned int max_orphans, FastRandomContext& rng)
         m_next_sweep = nMinExpTime + ORPHAN_TX_EXPIRE_INTERVAL;
         if (nErased > 0) LogDebug(BCLog::TXPACKAGES, "Erased %d orphan tx due to expiration\n", nErased);
     }
-    while (m_orphans.size() > max_orphans)
-    {
-        // Evict a random orphan:
-        size_t randompos = rng.randrange(m_orphan_list.size());
-        EraseTx(m_orphan_list[randompos]->second.tx->GetWitnessHash());
+    // Each peer providing orphans is entitled to an equal share of the orphan count limit and to
+    // RESERVED_ORPHAN_WEIGHT_PER_PEER weight. When either limit is exceeded, at least one
+    // peer exceeds its share of it: evict from the peer exceeding its shares the most.
+    while (m_orphans.size() > max_orphans ||
+           m_total_orphan_usage > RESERVED_ORPHAN_WEIGHT_PER_PEER * int64_t(m_peer_orphanage_info.size())) {
+        const double num_peers(m_peer_orphanage_info.size());
+        const auto share_used = [&](const PeerOrphanInfo& info) {
+            return std::max(double(info.total_usage) / RESERVED_ORPHAN_WEIGHT_PER_PEER,
+                            double(info.orphans_by_age.size()) * num_peers / std::max(max_orphans, 1U));
+        };
+        const auto worst_peer = std::max_element(m_peer_orphanage_info.begin(), m_peer_orphanage_info.end(),
+                                                 [&](const auto& a, const auto& b) { return share_used(a.second) < share_used(b.second); });
+        // Evict that peer's oldest orphan.
+        EraseTx(worst_peer->second.orphans_by_age.begin()->second->first);
         ++nEvicted;
     }
     if (nEvicted > 0) LogDebug(BCLog::TXPACKAGES, "orphanage overflow, removed %u tx\n", nEvicted);
@@ -147,6 +159,12 @@ void TxOrphanage::AddChildrenToWorkSet(const CTransaction& tx)
     }
 }
 
+int64_t TxOrphanage::UsageByPeer(NodeId peer) const
+{
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    return peer_it == m_peer_orphanage_info.end() ? 0 : peer_it->second.total_usage;
+}
+
 bool TxOrphanage::HaveTx(const Wtxid& wtxid) const
 {
     return m_orphans.count(wtxid);
@@ -9,20 +9,29 @@
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <sync.h>
+#include <util/hasher.h>
 #include <util/time.h>
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 /** Expiration time for orphan transactions */
 static constexpr auto ORPHAN_TX_EXPIRE_TIME{20min};
 /** Minimum time between orphan transactions expire time checks */
 static constexpr auto ORPHAN_TX_EXPIRE_INTERVAL{5min};
+/** Weight of orphans each peer can store without its orphans being the first evicted. Enough for
+ *  one maximum-size standard transaction. */
+static constexpr int64_t RESERVED_ORPHAN_WEIGHT_PER_PEER{404'000};
 
 /** A class to track orphan transactions (failed on TX_MISSING_INPUTS)
  * Since we cannot distinguish orphans from bad transactions with
  * non-existent inputs, we heavily limit the number of orphans
  * we keep and the duration we keep them for.
+ *
+ * The space is shared between the peers which provided orphans: when it runs out, orphans are
+ * evicted from the peer using the largest share of it, so that a peer flooding the orphanage
+ * only evicts its own orphans rather than those of honest peers.
  * Not thread-safe. Requires external synchronization.
  */
 class TxOrphanage {
@@ -49,8 +58,15 @@ public:
     /** Erase all orphans included in or invalidated by a new block */
     void EraseForBlock(const CBlock& block);
 
-    /** Limit the orphanage to the given maximum */
-    void LimitOrphans(unsigned int max_orphans, FastRandomContext& rng);
+    /** Erase expired orphans, then limit the orphanage to max_orphans transactions and to
+     *  RESERVED_ORPHAN_WEIGHT_PER_PEER weight per peer providing orphans. While over either
+     *  limit, the oldest orphan of the peer with the largest share of the limits is evicted.
+     *
+     *  Each peer's share of the count limit is max_orphans divided by the number of peers
+     *  providing orphans, however few orphans the others provide. With 20 other peers filling the
+     *  orphanage, an honest peer relaying a package of 10 orphans is over its share of about 5,
+     *  so its orphans are the first evicted. */
+    void LimitOrphans(unsigned int max_orphans);
 
     /** Add any orphans that list a particular tx as a parent into the from peer's work set */
     void AddChildrenToWorkSet(const CTransaction& tx);
@@ -72,6 +88,12 @@ public:
         return m_orphans.size();
     }
 
+    /** Total weight of the orphans */
+    int64_t TotalOrphanUsage() const { return m_total_orphan_usage; }
+
+    /** Total weight of the orphans provided by a peer */
+    int64_t UsageByPeer(NodeId peer) const;
+
     /** Allows providing orphan information externally */
     struct OrphanTxBase {
         CTransactionRef tx;
@@ -83,7 +105,10 @@ public:
 
 protected:
     struct OrphanTx : public OrphanTxBase {
-        size_t list_pos;
+        /** Order in which orphans were added, so that a peer's oldest orphans are evicted first */
+        uint64_t sequence;
+        /** Transaction weight, accounted to fromPeer */
+        int64_t weight;
     };
 
     /** Map from wtxid to orphan transaction record. Limited by
@@ -104,12 +129,26 @@ protected:
         }
     };
 
-    /** Index from the parents' COutPoint into the m_orphans. Used
-     *  to remove orphan transactions from the m_orphans */
-    std::map<COutPoint, std::set<OrphanMap::iterator, IteratorComparator>> m_outpoint_to_orphan_it;
+    /** Index from the parents' COutPoint into the m_orphans. Used to find the children of a
+     *  transaction and to remove orphan transactions spending the inputs of a block */
+    std::unordered_map<COutPoint, std::set<OrphanMap::iterator, IteratorComparator>, SaltedOutpointHasher> m_outpoint_to_orphan_it;
+
+    /** Orphans provided by a peer */
+    struct PeerOrphanInfo {
+        /** The peer's orphans by sequence, oldest first */
+        std::map<uint64_t, OrphanMap::iterator> orphans_by_age;
+        /** Total weight of the peer's orphans */
+        int64_t total_usage{0};
+    };
+
+    /** Orphans of each peer which provided any. Peers without orphans have no entry. */
+    std::map<NodeId, PeerOrphanInfo> m_peer_orphanage_info;
+
+    /** Total weight of the orphans in m_orphans */
+    int64_t m_total_orphan_usage{0};
 
-    /** Orphan transactions in vector for quick random eviction */
-    std::vector<OrphanMap::iterator> m_orphan_list;
+    /** Sequence number of the next orphan added */
+    uint64_t m_next_sequence{0};
 
     /** Timestamp for the next scheduled sweep of expired orphans */
     NodeSeconds m_next_sweep{0s};
@@ -11,6 +11,7 @@
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <optional>
 #include <ostream>
@@ -49,8 +50,10 @@ bool IsHex(std::string_view str)
 template <typename Byte>
 std::optional<std::vector<Byte>> TryParseHex(std::string_view str)
 {
-    std::vector<Byte> vch;
-    vch.reserve(str.size() / 2); // two hex characters form a single byte
+    // Two hex characters form a single byte. Size the output for the common case of no
+    // whitespace up front, and trim it at the end.
+    std::vector<Byte> vch(str.size() / 2);
+    auto out = vch.begin();
 
     auto it = str.begin();
     while (it != str.end()) {
@@ -58,12 +61,13 @@ std::optional<std::vector<Byte>> TryParseHex(std::string_view str)
             ++it;
             continue;
         }
-        auto c1 = HexDigit(*(it++));
-        if (it == str.end()) return std::nullopt;
-        auto c2 = HexDigit(*(it++));
-        if (c1 < 0 || c2 < 0) return std::nullopt;
-        vch.push_back(Byte(c1 << 4) | Byte(c2));
+        if (std::next(it) == str.end()) return std::nullopt;
+        const auto c1 = HexDigit(*(it++));
+        const auto c2 = HexDigit(*(it++));
+        if ((c1 | c2) < 0) return std::nullopt;
+        *(out++) = Byte(c1 << 4 | c2);
     }
+    vch.erase(out, vch.end());
     return vch;
 }
 template std::optional<std::vector<std::byte>> TryParseHex(std::string_view);
@@ -58,21 +58,28 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <validationinterface.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 using kernel::CCoinsStats;
@@ -132,7 +139,8 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
                        ValidationCache& validation_cache,
-                       std::vector<CScriptCheck>* pvChecks = nullptr)
+                       std::vector<CScriptCheck>* pvChecks = nullptr,
+                       DeferredTxDataInit* txdata_init = nullptr)
                        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 bool CheckFinalTxAtTip(const CBlockIndex& active_chain_tip, const CTransaction& tx)
@@ -2087,6 +2095,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txund
 }
 
 bool CScriptCheck::operator()() {
+    if (m_txdata_init) m_txdata_init->Init(*ptxTo, *txdata);
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata), &error);
@@ -2118,6 +2127,10 @@ ValidationCache::ValidationCache(const size_t script_execution_cache_bytes, cons
  * script checks which are not necessary (eg due to script execution cache hits) are, obviously,
  * not pushed onto pvChecks/run.
  *
+ * If txdata_init is not nullptr as well, txdata is not initialized here. The spent outputs are
+ * handed to txdata_init instead, and the first of the pushed checks to run computes the
+ * precomputed transaction data.
+ *
  * Setting cacheSigStore/cacheFullScriptStore to false will remove elements from the corresponding cache
  * which are matched. This is useful for checking blocks where we will likely never need the cache
  * entry again.
@@ -2131,7 +2144,8 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
                        ValidationCache& validation_cache,
-                       std::vector<CScriptCheck>* pvChecks)
+                       std::vector<CScriptCheck>* pvChecks,
+                       DeferredTxDataInit* txdata_init)
 {
     if (tx.IsCoinBase()) return true;
 
@@ -2152,6 +2166,20 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
         return true;
     }
 
+    if (pvChecks && txdata_init && !txdata.m_spent_outputs_ready) {
+        std::vector<CTxOut> spent_outputs;
+        spent_outputs.reserve(tx.vin.size());
+
+        for (unsigned int i = 0; i < tx.vin.size(); i++) {
+            const Coin& coin = inputs.AccessCoin(tx.vin[i].prevout);
+            assert(!coin.IsSpent());
+            spent_outputs.emplace_back(coin.out);
+            pvChecks->emplace_back(coin.out, tx, validation_cache.m_signature_cache, i, flags, cacheSigStore, &txdata, txdata_init);
+        }
+        txdata_init->SetSpentOutputs(std::move(spent_outputs));
+        return true;
+    }
+
     if (!txdata.m_spent_outputs_ready) {
         std::vector<CTxOut> spent_outputs;
         spent_outputs.reserve(tx.vin.size());
@@ -2258,16 +2286,17 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CBlockUndo* prefetched_undo)
 {
     AssertLockHeld(::cs_main);
     bool fClean = true;
 
-    CBlockUndo blockUndo;
-    if (!m_blockman.UndoReadFromDisk(blockUndo, *pindex)) {
+    CBlockUndo undo_from_disk;
+    if (!prefetched_undo && !m_blockman.UndoReadFromDisk(undo_from_disk, *pindex)) {
         LogError("DisconnectBlock(): failure reading undo data\n");
         return DISCONNECT_FAILED;
     }
+    CBlockUndo& blockUndo{prefetched_undo ? *prefetched_undo : undo_from_disk};
 
     if (blockUndo.vtxundo.size() + 1 != block.vtx.size()) {
         LogError("DisconnectBlock(): block and undo data inconsistent\n");
@@ -2600,6 +2629,10 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // for as long as `control`.
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && parallel_script_checks ? &m_chainman.GetCheckQueue() : nullptr);
     std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
+    // When checking in parallel, each transaction's precomputed data is
+    // initialized by the first of its script checks to run, so the hashing is
+    // spread over the script check threads.
+    std::vector<DeferredTxDataInit> txsdata_init(parallel_script_checks ? block.vtx.size() : 0);
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
@@ -2658,7 +2691,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
             TxValidationState tx_state;
-            if (fScriptChecks && !CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, parallel_script_checks ? &vChecks : nullptr)) {
+            if (fScriptChecks && !CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, parallel_script_checks ? &vChecks : nullptr, parallel_script_checks ? &txsdata_init[i] : nullptr)) {
                 // Any transaction validation failure in ConnectBlock is a block consensus failure
                 state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
                               tx_state.GetRejectReason(), tx_state.GetDebugMessage());
@@ -3015,7 +3048,7 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
   * disconnectpool (note that the caller is responsible for mempool consistency
   * in any case).
   */
-bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool)
+bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool, std::optional<DisconnectBlockData> prefetched)
 {
     AssertLockHeld(cs_main);
     if (m_mempool) AssertLockHeld(m_mempool->cs);
@@ -3023,10 +3056,13 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     CBlockIndex *pindexDelete = m_chain.Tip();
     assert(pindexDelete);
     assert(pindexDelete->pprev);
-    // Read block from disk.
-    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    // Read block from disk, unless it was read ahead of time.
+    if (prefetched && prefetched->block->GetHash() != pindexDelete->GetBlockHash()) {
+        prefetched.reset();
+    }
+    std::shared_ptr<CBlock> pblock = prefetched ? prefetched->block : std::make_shared<CBlock>();
     CBlock& block = *pblock;
-    if (!m_blockman.ReadBlockFromDisk(block, *pindexDelete)) {
+    if (!prefetched && !m_blockman.ReadBlockFromDisk(block, *pindexDelete)) {
         LogError("DisconnectTip(): Failed to read block\n");
         return false;
     }
@@ -3035,7 +3071,7 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     {
         CCoinsViewCache view(&CoinsTip());
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK) {
+        if (DisconnectBlock(block, pindexDelete, view, prefetched ? &prefetched->undo : nullptr) != DISCONNECT_OK) {
             LogError("DisconnectTip(): DisconnectBlock %s failed\n", pindexDelete->GetBlockHash().ToString());
             return false;
         }
@@ -3080,6 +3116,86 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     return true;
 }
 
+namespace {
+/**
+ * Reads the block and undo data of the blocks a reorg is about to disconnect
+ * on a background thread, a few blocks ahead of DisconnectTip, so that disk
+ * reads overlap with restoring the coins of the block being disconnected.
+ *
+ * The reader does not take cs_main: the positions of all blocks are looked up
+ * by the caller up front. A block that could not be read is simply not
+ * handed over, and DisconnectTip then reads it itself (and reports the error).
+ */
+class DisconnectBlockPrefetcher
+{
+public:
+    struct Entry {
+        FlatFilePos block_pos;
+        FlatFilePos undo_pos;
+        uint256 prev_hash;
+    };
+
+    //! Maximum number of blocks read ahead of the one being disconnected.
+    static constexpr size_t MAX_PREFETCHED_BLOCKS{4};
+
+    DisconnectBlockPrefetcher(const node::BlockManager& blockman, std::vector<Entry> entries)
+        : m_blockman{blockman}, m_entries{std::move(entries)}
+    {
+        m_thread = std::thread(&util::TraceThread, "disconnectread", [this] { ThreadRead(); });
+    }
+
+    ~DisconnectBlockPrefetcher()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    //! Wait for the next block in disconnection order to be read. Returns
+    //! std::nullopt if it could not be read.
+    std::optional<DisconnectBlockData> Next() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_read.empty() || m_done; });
+        if (m_read.empty()) return std::nullopt;
+        auto data{std::move(m_read.front())};
+        m_read.pop_front();
+        m_cv.notify_all();
+        return data;
+    }
+
+private:
+    const node::BlockManager& m_blockman;
+    const std::vector<Entry> m_entries;
+
+    std::thread m_thread;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::optional<DisconnectBlockData>> m_read GUARDED_BY(m_mutex);
+    bool m_done GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    void ThreadRead() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        for (const Entry& entry : m_entries) {
+            std::optional<DisconnectBlockData> data{DisconnectBlockData{std::make_shared<CBlock>(), {}}};
+            if (!m_blockman.ReadBlockFromDisk(*data->block, entry.block_pos) ||
+                !m_blockman.UndoReadFromDisk(data->undo, entry.undo_pos, entry.prev_hash)) {
+                data.reset();
+            }
+
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_read.size() < MAX_PREFETCHED_BLOCKS || m_stop; });
+            if (m_stop) break;
+            m_read.push_back(std::move(data));
+            m_cv.notify_all();
+        }
+        WITH_LOCK(m_mutex, m_done = true);
+        m_cv.notify_all();
+    }
+};
+} // namespace
+
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
     std::shared_ptr<const CBlock> pblock;
@@ -3316,8 +3432,19 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
     // Disconnect active blocks which are no longer in the best chain.
     bool fBlocksDisconnected = false;
     DisconnectedBlockTransactions disconnectpool{MAX_DISCONNECTED_TX_POOL_BYTES};
+
+    // When disconnecting more than one block, read them from disk ahead of time.
+    std::optional<DisconnectBlockPrefetcher> prefetcher;
+    if (pindexOldTip && pindexOldTip->pprev && pindexOldTip->pprev != pindexFork) {
+        std::vector<DisconnectBlockPrefetcher::Entry> entries;
+        for (const CBlockIndex* pindex = pindexOldTip; pindex && pindex != pindexFork && pindex->pprev; pindex = pindex->pprev) {
+            entries.push_back({pindex->GetBlockPos(), pindex->GetUndoPos(), pindex->pprev->GetBlockHash()});
+        }
+        prefetcher.emplace(m_blockman, std::move(entries));
+    }
+
     while (m_chain.Tip() && m_chain.Tip() != pindexFork) {
-        if (!DisconnectTip(state, &disconnectpool)) {
+        if (!DisconnectTip(state, &disconnectpool, prefetcher ? prefetcher->Next() : std::nullopt)) {
             // This is likely a fatal error, but keep the mempool consistent,
             // just in case. Only remove from the mempool in this case.
             MaybeUpdateMempoolForReorg(disconnectpool, false);
@@ -4091,12 +4218,6 @@ std::vector<unsigned char> ChainstateManager::GenerateCoinbaseCommitment(CBlock&
     return commitment;
 }
 
-bool HasValidProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams)
-{
-    return std::all_of(headers.cbegin(), headers.cend(),
-            [&](const auto& header) { return CheckProofOfWork(header.GetHash(), header.nBits, consensusParams);});
-}
-
 bool IsBlockMutated(const CBlock& block, bool check_witness_root)
 {
     BlockValidationState state;
@@ -4131,9 +4252,16 @@ bool IsBlockMutated(const CBlock& block, bool check_witness_root)
 arith_uint256 CalculateClaimedHeadersWork(std::span<const CBlockHeader> headers)
 {
     arith_uint256 total_work{0};
+    // The target rarely changes between consecutive headers, so only compute the (costly) work
+    // per header when it does.
+    uint32_t last_bits{0};
+    arith_uint256 header_work{0};
     for (const CBlockHeader& header : headers) {
-        CBlockIndex dummy(header);
-        total_work += GetBlockProof(dummy);
+        if (header.nBits != last_bits) {
+            header_work = GetBlockProof(CBlockIndex(header));
+            last_bits = header.nBits;
+        }
+        total_work += header_work;
     }
     return total_work;
 }
@@ -5192,6 +5320,266 @@ void ChainstateManager::LoadExternalBlockFile(
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 }
 
+namespace {
+/** A block found while scanning a block file during reindex. */
+struct ScannedBlock {
+    uint256 hash;
+    uint256 prev_hash;
+    FlatFilePos pos;
+};
+
+/**
+ * Find all blocks in a block file, reading only their headers. Uses the same
+ * search for message start bytes as LoadExternalBlockFile, so data that does
+ * not deserialize cleanly is skipped in the same way.
+ */
+std::vector<ScannedBlock> ScanBlockFile(AutoFile& file_in, int file_num, const MessageStartChars& message_start, const util::SignalInterrupt& interrupt)
+{
+    std::vector<ScannedBlock> blocks;
+    BufferedFile blkdat{file_in, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
+    uint64_t nRewind = blkdat.GetPos();
+    while (!blkdat.eof()) {
+        if (interrupt) break;
+
+        blkdat.SetPos(nRewind);
+        nRewind++; // start one byte further next time, in case of failure
+        blkdat.SetLimit(); // remove former limit
+        unsigned int nSize = 0;
+        try {
+            // locate a header
+            MessageStartChars buf;
+            blkdat.FindByte(std::byte(message_start[0]));
+            nRewind = blkdat.GetPos() + 1;
+            blkdat >> buf;
+            if (buf != message_start) {
+                continue;
+            }
+            // read size
+            blkdat >> nSize;
+            if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
+                continue;
+        } catch (const std::exception&) {
+            // no valid block header found; don't complain
+            break;
+        }
+        try {
+            const uint64_t nBlockPos{blkdat.GetPos()};
+            blkdat.SetLimit(nBlockPos + nSize);
+            CBlockHeader header;
+            blkdat >> header;
+            nRewind = nBlockPos + nSize;
+            blkdat.SkipTo(nRewind);
+            blocks.push_back({header.GetHash(), header.hashPrevBlock, FlatFilePos{file_num, static_cast<unsigned int>(nBlockPos)}});
+        } catch (const std::exception& e) {
+            LogDebug(BCLog::REINDEX, "%s: unexpected data at offset 0x%x of blk%05u.dat - %s. continuing\n", __func__, (nRewind - 1), (unsigned int)file_num, e.what());
+        }
+    }
+    return blocks;
+}
+
+/**
+ * Reads blocks from disk in a given order on worker threads, a bounded number
+ * of blocks ahead of the consumer, and runs the context-free CheckBlock on
+ * them so that this is not done while holding cs_main.
+ */
+class ReindexBlockReader
+{
+public:
+    //! Maximum number of blocks read ahead of the one being processed.
+    static constexpr size_t MAX_READ_AHEAD_BLOCKS{64};
+
+    ReindexBlockReader(const node::BlockManager& blockman, const Consensus::Params& consensus, std::vector<FlatFilePos> positions, int num_threads)
+        : m_blockman{blockman}, m_consensus{consensus}, m_positions{std::move(positions)}
+    {
+        for (int n = 0; n < num_threads; ++n) {
+            m_threads.emplace_back(&util::TraceThread, strprintf("reindex.%i", n), [this] { ThreadRead(); });
+        }
+    }
+
+    ~ReindexBlockReader()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        for (std::thread& t : m_threads) {
+            t.join();
+        }
+    }
+
+    //! Wait for the next block in order. Returns nullptr if it could not be read.
+    std::shared_ptr<CBlock> Next() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_read.contains(m_next_out); });
+        auto node{m_read.extract(m_next_out++)};
+        m_cv.notify_all();
+        return std::move(node.mapped());
+    }
+
+private:
+    const node::BlockManager& m_blockman;
+    const Consensus::Params& m_consensus;
+    const std::vector<FlatFilePos> m_positions;
+
+    std::vector<std::thread> m_threads;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Blocks read but not yet handed out, by index into m_positions.
+    std::map<size_t, std::shared_ptr<CBlock>> m_read GUARDED_BY(m_mutex);
+    size_t m_next_read GUARDED_BY(m_mutex){0};
+    size_t m_next_out GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    void ThreadRead() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            size_t index;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                    return m_stop || m_next_read >= m_positions.size() || m_next_read < m_next_out + MAX_READ_AHEAD_BLOCKS;
+                });
+                if (m_stop || m_next_read >= m_positions.size()) return;
+                index = m_next_read++;
+            }
+
+            auto pblock{std::make_shared<CBlock>()};
+            if (m_blockman.ReadBlockFromDisk(*pblock, m_positions[index])) {
+                // The result is cached in CBlock::fChecked; a block failing
+                // these checks is rejected again by AcceptBlock.
+                BlockValidationState state;
+                CheckBlock(*pblock, state, m_consensus);
+            } else {
+                pblock.reset();
+            }
+
+            WITH_LOCK(m_mutex, m_read.emplace(index, std::move(pblock)));
+            m_cv.notify_all();
+        }
+    }
+};
+} // namespace
+
+void ChainstateManager::ReindexBlockFiles()
+{
+    const auto start{SteadyClock::now()};
+    const CChainParams& params{GetParams()};
+    const int num_threads{std::max(1, m_options.worker_threads_num)};
+
+    // Find all blocks in all block files, scanning several files at once.
+    int num_files{0};
+    while (fs::exists(m_blockman.GetBlockPosFilename(FlatFilePos(num_files, 0)))) {
+        ++num_files;
+    }
+    std::vector<std::vector<ScannedBlock>> scanned(num_files);
+    {
+        std::atomic<int> next_file{0};
+        auto scan_files{[&] {
+            for (int file_num{next_file++}; file_num < num_files && !m_interrupt; file_num = next_file++) {
+                AutoFile file{m_blockman.OpenBlockFile(FlatFilePos(file_num, 0), true)};
+                if (file.IsNull()) continue; // This error is logged in OpenBlockFile
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)file_num);
+                try {
+                    scanned[file_num] = ScanBlockFile(file, file_num, params.MessageStart(), m_interrupt);
+                } catch (const std::runtime_error& e) {
+                    GetNotifications().fatalError(strprintf(_("System error while loading external block file: %s"), e.what()));
+                }
+            }
+        }};
+        std::vector<std::thread> threads;
+        for (int n = 1; n < std::min(num_threads, num_files); ++n) {
+            threads.emplace_back(&util::TraceThread, strprintf("reindex.%i", n), scan_files);
+        }
+        scan_files();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+    if (m_interrupt) return;
+
+    // Order the blocks so that each one comes after its parent. Blocks whose
+    // parent has not been seen yet are held back until it is, wherever in the
+    // block files that is.
+    std::vector<const ScannedBlock*> ordered;
+    {
+        LOCK(cs_main);
+        std::unordered_set<uint256, BlockHasher> known;
+        std::unordered_multimap<uint256, const ScannedBlock*, BlockHasher> unknown_parent;
+        for (const auto& file_blocks : scanned) {
+            for (const ScannedBlock& block : file_blocks) {
+                if (block.hash != params.GetConsensus().hashGenesisBlock && !known.contains(block.prev_hash) && !m_blockman.LookupBlockIndex(block.prev_hash)) {
+                    LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, block.hash.ToString(),
+                             block.prev_hash.ToString());
+                    unknown_parent.emplace(block.prev_hash, &block);
+                    continue;
+                }
+                std::deque<const ScannedBlock*> queue{&block};
+                while (!queue.empty()) {
+                    const ScannedBlock* next{queue.front()};
+                    queue.pop_front();
+                    if (known.insert(next->hash).second) {
+                        const CBlockIndex* pindex{m_blockman.LookupBlockIndex(next->hash)};
+                        if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+                            ordered.push_back(next);
+                        }
+                    }
+                    auto range{unknown_parent.equal_range(next->hash)};
+                    for (auto it{range.first}; it != range.second; ++it) {
+                        LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, it->second->hash.ToString(),
+                                 next->hash.ToString());
+                        queue.push_back(it->second);
+                    }
+                    unknown_parent.erase(range.first, range.second);
+                }
+            }
+        }
+    }
+
+    // Add the blocks to the block index in that order, while they are read
+    // from disk ahead of time.
+    std::vector<FlatFilePos> positions;
+    positions.reserve(ordered.size());
+    for (const ScannedBlock* block : ordered) {
+        positions.push_back(block->pos);
+    }
+    int nLoaded = 0;
+    ReindexBlockReader reader{m_blockman, params.GetConsensus(), std::move(positions), num_threads};
+    for (const ScannedBlock* block : ordered) {
+        if (m_interrupt) return;
+
+        const std::shared_ptr<CBlock> pblock{reader.Next()};
+        if (!pblock) continue; // This error is logged in ReadBlockFromDisk
+
+        {
+            LOCK(cs_main);
+            BlockValidationState state;
+            if (AcceptBlock(pblock, state, nullptr, true, &block->pos, nullptr, true)) {
+                nLoaded++;
+            }
+            if (state.IsError()) {
+                break;
+            }
+        }
+
+        // Activate the genesis block so normal node progress can continue
+        if (block->hash == params.GetConsensus().hashGenesisBlock) {
+            bool genesis_activation_failure = false;
+            for (auto c : GetAll()) {
+                BlockValidationState state;
+                if (!c->ActivateBestChain(state, nullptr)) {
+                    genesis_activation_failure = true;
+                    break;
+                }
+            }
+            if (genesis_activation_failure) {
+                break;
+            }
+        }
+
+        NotifyHeaderTip();
+    }
+    LogPrintf("Loaded %i blocks from %i block files in %dms\n", nLoaded, num_files, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
+
 bool ChainstateManager::ShouldCheckBlockIndex() const
 {
     // Assert to verify Flatten() has been called.
@@ -5825,6 +6213,178 @@ static void SnapshotUTXOHashBreakpoint(const util::SignalInterrupt& interrupt)
     if (interrupt) throw StopHashingException();
 }
 
+namespace {
+/**
+ * Deserializes the coins of a UTXO snapshot on a background thread and hands
+ * them to the loading thread in batches, so that decoding overlaps with
+ * inserting into (and flushing) the snapshot chainstate's coins cache.
+ *
+ * While decoding, the reader also feeds every coin into the HASH_SERIALIZED
+ * commitment. As long as the snapshot lists its coins in strictly increasing
+ * outpoint order (which is how dumptxoutset writes them), this yields exactly
+ * the hash ComputeUTXOStats would compute over the loaded chainstate, and
+ * re-reading the whole coins database afterwards can be skipped.
+ */
+class SnapshotCoinsReader
+{
+public:
+    using Batch = std::vector<std::pair<COutPoint, Coin>>;
+
+    //! Number of coins handed over per batch.
+    static constexpr size_t BATCH_SIZE{120'000};
+    //! Number of decoded batches that may be waiting for the loading thread.
+    static constexpr size_t MAX_PENDING_BATCHES{2};
+
+    SnapshotCoinsReader(AutoFile& coins_file, uint64_t coins_count, int base_height)
+        : m_coins_file{coins_file}, m_coins_count{coins_count}, m_base_height{base_height}
+    {
+        m_thread = std::thread(&util::TraceThread, "loadsnapshot", [this] { ThreadRead(); });
+    }
+
+    ~SnapshotCoinsReader()
+    {
+        Stop();
+    }
+
+    //! Block until the next batch of coins is available. Returns std::nullopt
+    //! once all coins have been read or the reader stopped on an error.
+    std::optional<Batch> Next() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_pending.empty() || m_done; });
+        if (m_pending.empty()) return std::nullopt;
+        Batch batch{std::move(m_pending.front())};
+        m_pending.pop_front();
+        m_cv.notify_all();
+        return batch;
+    }
+
+    //! Abort reading (if still in progress) and wait for the thread to exit.
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            LOCK(m_mutex);
+            m_abort = true;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    //! Why reading the coins failed, if it did. Only valid after Stop().
+    const std::optional<bilingual_str>& Error() const { return m_error; }
+
+    //! Content hash of the coins read, or std::nullopt if the snapshot was not
+    //! in canonical order and the hash must be computed from the chainstate.
+    //! Only valid after Stop().
+    const std::optional<uint256>& StreamedHash() const { return m_hash; }
+
+private:
+    AutoFile& m_coins_file;
+    const uint64_t m_coins_count;
+    const int m_base_height;
+
+    std::thread m_thread;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Batch> m_pending GUARDED_BY(m_mutex);
+    bool m_done GUARDED_BY(m_mutex){false};
+    bool m_abort GUARDED_BY(m_mutex){false};
+
+    std::optional<bilingual_str> m_error;
+    std::optional<uint256> m_hash;
+
+    //! Queue a batch for the loading thread. Returns false if reading was aborted.
+    bool Push(Batch&& batch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_pending.size() < MAX_PENDING_BATCHES || m_abort; });
+        if (m_abort) return false;
+        m_pending.push_back(std::move(batch));
+        m_cv.notify_all();
+        return true;
+    }
+
+    void ThreadRead() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (auto res{Read()}; !res) m_error = util::ErrorString(res);
+        {
+            LOCK(m_mutex);
+            m_done = true;
+        }
+        m_cv.notify_all();
+    }
+
+    util::Result<void> Read() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        uint64_t coins_left{m_coins_count};
+        HashWriter hasher{};
+        std::optional<COutPoint> last_outpoint;
+        bool canonical{true};
+        Batch batch;
+        batch.reserve(BATCH_SIZE);
+
+        while (coins_left > 0) {
+            try {
+                Txid txid;
+                m_coins_file >> txid;
+                size_t coins_per_txid{0};
+                coins_per_txid = ReadCompactSize(m_coins_file);
+
+                if (coins_per_txid > coins_left) {
+                    return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+                }
+
+                for (size_t i = 0; i < coins_per_txid; i++) {
+                    COutPoint outpoint;
+                    Coin coin;
+                    outpoint.n = static_cast<uint32_t>(ReadCompactSize(m_coins_file));
+                    outpoint.hash = txid;
+                    m_coins_file >> coin;
+                    if (coin.nHeight > m_base_height ||
+                        outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                    ) {
+                        return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins"),
+                                  m_coins_count - coins_left)};
+                    }
+                    if (!MoneyRange(coin.out.nValue)) {
+                        return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins - bad tx out value"),
+                                  m_coins_count - coins_left)};
+                    }
+
+                    // Duplicate or out-of-order outpoints would make the
+                    // streamed hash diverge from the one over the resulting
+                    // chainstate, so stop hashing and leave it to the caller.
+                    if (canonical) {
+                        if (last_outpoint && !(*last_outpoint < outpoint)) {
+                            canonical = false;
+                        } else {
+                            kernel::ApplyCoinHash(hasher, outpoint, coin);
+                            last_outpoint = outpoint;
+                        }
+                    }
+
+                    batch.emplace_back(std::move(outpoint), std::move(coin));
+                    --coins_left;
+
+                    if (batch.size() == BATCH_SIZE) {
+                        if (!Push(std::move(batch))) return {};
+                        batch = Batch{};
+                        batch.reserve(BATCH_SIZE);
+                    }
+                }
+            } catch (const std::ios_base::failure&) {
+                return util::Error{strprintf(Untranslated("Bad snapshot format or truncated snapshot after deserializing %d coins"),
+                          m_coins_count - coins_left)};
+            }
+        }
+        if (!batch.empty() && !Push(std::move(batch))) return {};
+
+        if (canonical) m_hash = hasher.GetHash();
+        return {};
+    }
+};
+} // namespace
+
 util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     Chainstate& snapshot_chainstate,
     AutoFile& coins_file,
@@ -5863,79 +6423,53 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     }
 
     const uint64_t coins_count = metadata.m_coins_count;
-    uint64_t coins_left = metadata.m_coins_count;
 
-    LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
+    LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_count, base_blockhash.ToString());
     int64_t coins_processed{0};
 
-    while (coins_left > 0) {
-        try {
-            Txid txid;
-            coins_file >> txid;
-            size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
-
-            if (coins_per_txid > coins_left) {
-                return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
-            }
+    SnapshotCoinsReader reader{coins_file, coins_count, base_height};
 
-            for (size_t i = 0; i < coins_per_txid; i++) {
-                COutPoint outpoint;
-                Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
-                outpoint.hash = txid;
-                coins_file >> coin;
-                if (coin.nHeight > base_height ||
-                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-                ) {
-                    return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins"),
-                              coins_count - coins_left)};
-                }
-                if (!MoneyRange(coin.out.nValue)) {
-                    return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins - bad tx out value"),
-                              coins_count - coins_left)};
-                }
-                coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
+    while (auto batch{reader.Next()}) {
+        for (auto& [outpoint, coin] : *batch) {
+            coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
 
-                --coins_left;
-                ++coins_processed;
+            ++coins_processed;
 
-                if (coins_processed % 1000000 == 0) {
-                    LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
-                        coins_processed,
-                        static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
-                        coins_cache.DynamicMemoryUsage() / (1000 * 1000));
-                }
+            if (coins_processed % 1000000 == 0) {
+                LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
+                    coins_processed,
+                    static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
+                    coins_cache.DynamicMemoryUsage() / (1000 * 1000));
+            }
+        }
 
-                // Batch write and flush (if we need to) every so often.
-                //
-                // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
-                // means <5MB of memory imprecision.
-                if (coins_processed % 120000 == 0) {
-                    if (m_interrupt) {
-                        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-                    }
+        // Batch write and flush (if we need to) after every batch.
+        //
+        // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
+        // means <5MB of memory imprecision.
+        if (m_interrupt) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
 
-                    const auto snapshot_cache_state = WITH_LOCK(::cs_main,
-                        return snapshot_chainstate.GetCoinsCacheSizeState());
+        const auto snapshot_cache_state = WITH_LOCK(::cs_main,
+            return snapshot_chainstate.GetCoinsCacheSizeState());
 
-                    if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
-                        // This is a hack - we don't know what the actual best block is, but that
-                        // doesn't matter for the purposes of flushing the cache here. We'll set this
-                        // to its correct value (`base_blockhash`) below after the coins are loaded.
-                        coins_cache.SetBestBlock(GetRandHash());
+        if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
+            // This is a hack - we don't know what the actual best block is, but that
+            // doesn't matter for the purposes of flushing the cache here. We'll set this
+            // to its correct value (`base_blockhash`) below after the coins are loaded.
+            coins_cache.SetBestBlock(GetRandHash());
 
-                        // No need to acquire cs_main since this chainstate isn't being used yet.
-                        FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
-                    }
-                }
-            }
-        } catch (const std::ios_base::failure&) {
-            return util::Error{strprintf(Untranslated("Bad snapshot format or truncated snapshot after deserializing %d coins"),
-                      coins_processed)};
+            // No need to acquire cs_main since this chainstate isn't being used yet.
+            FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
         }
     }
 
+    reader.Stop();
+    if (reader.Error()) {
+        return util::Error{*reader.Error()};
+    }
+
     // Important that we set this. This and the coins_cache accesses above are
     // sort of a layer violation, but either we reach into the innards of
     // CCoinsViewCache here or we have to invert some of the Chainstate to
@@ -5970,22 +6504,31 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     // about the snapshot_chainstate.
     CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    std::optional<CCoinsStats> maybe_stats;
+    uint256 hash_serialized;
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+    if (reader.StreamedHash()) {
+        // The coins were read in canonical order, so the hash computed while
+        // reading them commits to exactly the contents of the chainstate.
+        hash_serialized = *reader.StreamedHash();
+    } else {
+        std::optional<CCoinsStats> maybe_stats;
+
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         return util::Error{strprintf(Untranslated("Bad snapshot content hash: expected %s, got %s"),
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString())};
+            au_data.hash_serialized.ToString(), hash_serialized.ToString())};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
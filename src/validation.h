@@ -27,6 +27,7 @@
 #include <txdb.h>
 #include <txmempool.h> // For CTxMemPool::cs
 #include <uint256.h>
+#include <undo.h>
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/hasher.h>
@@ -37,6 +38,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <span>
@@ -323,6 +325,26 @@ std::optional<LockPoints> CalculateLockPointsAtTip(
 bool CheckSequenceLocksAtTip(CBlockIndex* tip,
                              const LockPoints& lock_points);
 
+/**
+ * Spent outputs of a transaction whose PrecomputedTransactionData is initialized
+ * by whichever of its script checks runs first. This moves the transaction
+ * hashing off the validation thread and onto the script check threads.
+ */
+class DeferredTxDataInit
+{
+private:
+    std::once_flag m_once;
+    std::vector<CTxOut> m_spent_outputs;
+
+public:
+    void SetSpentOutputs(std::vector<CTxOut>&& spent_outputs) { m_spent_outputs = std::move(spent_outputs); }
+
+    void Init(const CTransaction& tx, PrecomputedTransactionData& txdata)
+    {
+        std::call_once(m_once, [&] { txdata.Init(tx, std::move(m_spent_outputs)); });
+    }
+};
+
 /**
  * Closure representing one script verification
  * Note that this stores references to the spending transaction
@@ -338,10 +360,12 @@ private:
     ScriptError error{SCRIPT_ERR_UNKNOWN_ERROR};
     PrecomputedTransactionData *txdata;
     SignatureCache* m_signature_cache;
+    //! If set, txdata is initialized through it before the script is verified.
+    DeferredTxDataInit* m_txdata_init;
 
 public:
-    CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, SignatureCache& signature_cache, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
-        m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache) { }
+    CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, SignatureCache& signature_cache, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn, DeferredTxDataInit* txdata_init = nullptr) :
+        m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache), m_txdata_init(txdata_init) { }
 
     CScriptCheck(const CScriptCheck&) = delete;
     CScriptCheck& operator=(const CScriptCheck&) = delete;
@@ -395,9 +419,6 @@ bool TestBlockValidity(BlockValidationState& state,
                        bool fCheckPOW = true,
                        bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-/** Check with the proof of work on each blockheader matches the value in nBits */
-bool HasValidProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
-
 /** Check if a block has been mutated (with respect to its merkle root and witness commitments). */
 bool IsBlockMutated(const CBlock& block, bool check_witness_root);
 
@@ -438,6 +459,12 @@ enum DisconnectResult
 
 class ConnectTrace;
 
+/** Block and undo data of a block to be disconnected, read from disk ahead of time. */
+struct DisconnectBlockData {
+    std::shared_ptr<CBlock> block;
+    CBlockUndo undo;
+};
+
 /** @see Chainstate::FlushStateToDisk */
 enum class FlushStateMode {
     NONE,
@@ -707,13 +734,14 @@ public:
         LOCKS_EXCLUDED(::cs_main);
 
     // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CBlockUndo* prefetched_undo = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
                       CCoinsViewCache& view, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-    // Apply the effects of a block disconnection on the UTXO set.
-    bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+    // Apply the effects of a block disconnection on the UTXO set. If the tip's
+    // block and undo data have already been read, they can be passed in.
+    bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool, std::optional<DisconnectBlockData> prefetched = std::nullopt) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
 
     // Manual block validity manipulation:
     /** Mark a block as precious and reorganize.
@@ -1151,7 +1179,8 @@ public:
     /**
      * Import blocks from an external file
      *
-     * During reindexing, this function is called for each block file (datadir/blocks/blk?????.dat).
+     * This function can be called for each block file (datadir/blocks/blk?????.dat) to load
+     * them one by one; -reindex uses ReindexBlockFiles() instead and no longer calls it.
      * It reads all blocks contained in the given file and attempts to process them (add them to the
      * block index). The blocks may be out of order within each file and across files. Often this
      * function reads a block but finds that its parent hasn't been read yet, so the block can't be
@@ -1169,16 +1198,27 @@ public:
      *
      *
      * @param[in]     file_in                       File containing blocks to read
-     * @param[in]     dbp                           (optional) Disk block position (only for reindex)
+     * @param[in]     dbp                           (optional) Disk block position (only for files
+     *                                              in the blocks directory)
      * @param[in,out] blocks_with_unknown_parent    (optional) Map of disk positions for blocks with
      *                                              unknown parent, key is parent block hash
-     *                                              (only used for reindex)
+     *                                              (only for files in the blocks directory)
      * */
     void LoadExternalBlockFile(
         AutoFile& file_in,
         FlatFilePos* dbp = nullptr,
         std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent = nullptr);
 
+    /**
+     * Rebuild the block index from all block files (-reindex).
+     *
+     * The block files are first scanned for block headers on several threads.
+     * The blocks are then added to the block index with every block following
+     * its parent, wherever in the block files either is stored, and read from
+     * disk and checked ahead of time by worker threads.
+     */
+    void ReindexBlockFiles();
+
     /**
      * Process an incoming block. This only returns after the best known valid
      * block is made active. Note that it does not, however, guarantee that the
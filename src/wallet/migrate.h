@@ -5,6 +5,7 @@
 #ifndef BITCOIN_WALLET_MIGRATE_H
 #define BITCOIN_WALLET_MIGRATE_H
 
+#include <support/allocators/zeroafterfree.h>
 #include <wallet/db.h>
 
 #include <optional>
@@ -8,6 +8,7 @@
 #include <config/bitcoin-config.h> // IWYU pragma: keep
 
 #include <addresstype.h>
+#include <support/allocators/zeroafterfree.h>
 #include <wallet/db.h>
 
 #include <memory>
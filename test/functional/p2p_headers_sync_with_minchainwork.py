@@ -11,6 +11,8 @@ from test_framework.p2p import (
 )
 
 from test_framework.messages import (
+    CBlockHeader,
+    from_hex,
     msg_headers,
 )
 
@@ -19,8 +21,12 @@ from test_framework.blocktools import (
     create_block,
 )
 
-from test_framework.util import assert_equal
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than_or_equal,
+)
 
+import shutil
 import time
 
 NODE1_BLOCKS_REQUIRED = 15
@@ -137,6 +143,40 @@ class RejectLowDifficultyHeadersTest(BitcoinTestFramework):
         # getpeerinfo should show a sync in progress
         assert_equal(node.getpeerinfo()[0]['presynced_headers'], 2000)
 
+    def test_presync_of_accepted_chain_ends(self):
+        self.log.info("Test that a headers presync ends without redownload once it reaches headers accepted from another peer")
+
+        # Restart node3 from scratch, without noban permissions, so that it requires as much chainwork
+        # as node2 from all of its peers.
+        node = self.nodes[3]
+        self.stop_node(3)
+        shutil.rmtree(node.blocks_path)
+        shutil.rmtree(node.chain_path / "chainstate")
+        self.start_node(3, extra_args=["-minimumchainwork=0x1000", "-checkblockindex=0"])
+        assert_equal(node.getblockcount(), 0)
+
+        # Two peers present the same chain, which is too little work in one headers message.
+        assert_greater_than_or_equal(self.nodes[0].getblockcount(), 4000)
+        headers = [from_hex(CBlockHeader(), self.nodes[0].getblockheader(self.nodes[0].getblockhash(height), False)) for height in range(1, 4001)]
+        peer1 = node.add_p2p_connection(P2PInterface())
+        peer2 = node.add_p2p_connection(P2PInterface())
+        for peer in [peer1, peer2]:
+            with node.assert_debug_log(expected_msgs=["Initial headers sync started with peer="]):
+                peer.send_and_ping(msg_headers(headers=headers[:2000]))
+
+        self.log.info("Complete the presync and redownload with the first peer")
+        with node.assert_debug_log(expected_msgs=["redownloading from height=0", "Initial headers sync complete with peer=0"]):
+            peer1.send_and_ping(msg_headers(headers=headers[2000:]))
+            peer1.send_and_ping(msg_headers(headers=headers[:2000]))
+            peer1.send_and_ping(msg_headers(headers=headers[2000:]))
+        assert_equal(node.getchaintips()[0]['height'], 4000)
+
+        self.log.info("Check that the second peer's presync ends on the accepted headers, without a redownload")
+        with node.assert_debug_log(expected_msgs=["Initial headers sync with peer=1 ended: received headers we already accepted"], unexpected_msgs=["redownloading from height"]):
+            peer2.send_and_ping(msg_headers(headers=headers[2000:]))
+        assert_equal(node.getpeerinfo()[1]['presynced_headers'], -1)
+        node.disconnect_p2ps()
+
     def test_large_reorgs_can_succeed(self):
         self.log.info("Test that a 2000+ block reorg, starting from a point that is more than 2000 blocks before a locator entry, can succeed")
 
@@ -167,6 +207,8 @@ class RejectLowDifficultyHeadersTest(BitcoinTestFramework):
 
         self.test_peerinfo_includes_headers_presync_height()
 
+        self.test_presync_of_accepted_chain_ends()
+
 
 
 if __name__ == '__main__':
@@ -47,7 +47,11 @@ class P2PStaller(P2PDataStore):
 class P2PIBDStallingTest(BitcoinTestFramework):
     def set_test_params(self):
         self.setup_clean_chain = True
-        self.num_nodes = 1
+        self.num_nodes = 2
+
+    def setup_network(self):
+        # Each node syncs the same blocks from its own test peers.
+        self.setup_nodes()
 
     def run_test(self):
         NUM_BLOCKS = 1025
@@ -143,6 +147,34 @@ class P2PIBDStallingTest(BitcoinTestFramework):
         self.log.info("Check that all outstanding blocks get connected")
         self.wait_until(lambda: node.getblockcount() == NUM_BLOCKS)
 
+        self.test_raced_staller_not_disconnected(blocks, block_dict)
+
+    def test_raced_staller_not_disconnected(self, blocks, block_dict):
+        self.log.info("Check that a staller is not disconnected when another peer delivers the block first")
+        node = self.nodes[1]
+        stall_block = blocks[0].sha256
+        headers_message = msg_headers(headers=[CBlockHeader(b) for b in blocks])
+        self.mocktime = int(time.time()) + 1
+        node.setmocktime(self.mocktime)
+
+        staller = node.add_outbound_p2p_connection(P2PStaller(stall_block), p2p_idx=0, connection_type="outbound-full-relay")
+        staller.block_store = block_dict
+        staller.send_and_ping(headers_message)
+        assert stall_block in staller.getdata_requests
+
+        # The second peer delivers every block, including the one the staller withholds, so the
+        # window fills up with everything but that block before it is raced for it.
+        with node.assert_debug_log(expected_msgs=["Stall started peer=0", "also in flight from stalling peer=0"]):
+            racer = node.add_outbound_p2p_connection(P2PStaller(stall_block=None), p2p_idx=1, connection_type="outbound-full-relay")
+            racer.block_store = block_dict
+            racer.send_message(headers_message)
+            self.wait_until(lambda: node.getblockcount() == len(blocks))
+
+        self.mocktime += 3
+        node.setmocktime(self.mocktime)
+        self.all_sync_send_with_ping([staller, racer])
+        assert_equal(node.num_test_p2p_connections(), 2)
+
     def total_bytes_recv_for_blocks(self):
         total = 0
         for info in self.nodes[0].getpeerinfo():
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction relay through set reconciliation (BIP 330).
+
+Relay the same number of transactions over the same topology, first by flooding
+and then with -txreconciliation, and compare the bandwidth spent on announcing
+them. Reconciliation replaces most of the redundant inv announcements of
+flooding, at the cost of reconciliation rounds that are sent whether there are
+transactions to reconcile or not. Enough transactions are relayed for that cost
+to be spread over many of them, as on a busy network.
+"""
+
+import time
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+)
+from test_framework.wallet import MiniWallet
+
+NUM_TXS = 200
+# Number of outbound connections per node. Each node floods new transactions to
+# one outbound peer and a tenth of its inbound peers, so there must be enough
+# peers left to reconcile with.
+NUM_OUTBOUND = 4
+# Time to let pending announcements go out after all nodes have the transactions.
+SETTLE_TIME = 10
+# Messages used to announce transactions, as opposed to sending them.
+ANNOUNCEMENT_MSGS = ["inv", "getdata", "reqrecon", "sketch", "reqsketchext", "reconcildiff"]
+RECONCILIATION_MSGS = ["reqrecon", "sketch", "reconcildiff"]
+
+
+class TxReconciliationTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 10
+
+    def setup_network(self):
+        self.setup_nodes()
+
+    def connect_ring(self):
+        # Each node connects to the next NUM_OUTBOUND nodes, so every node has
+        # NUM_OUTBOUND outbound and NUM_OUTBOUND inbound peers.
+        for i in range(self.num_nodes):
+            for j in range(1, NUM_OUTBOUND + 1):
+                self.connect_nodes(i, (i + j) % self.num_nodes)
+
+    def bytes_sent(self, msg_types):
+        return sum(peer["bytessent_per_msg"].get(msg_type, 0)
+                   for node in self.nodes
+                   for peer in node.getpeerinfo()
+                   for msg_type in msg_types)
+
+    def relay_transactions(self, reconcile):
+        """Relay NUM_TXS transactions from node 0 and return the bytes spent on
+        announcing them, on inv messages, and on reconciliation messages."""
+        self.restart_nodes(["-txreconciliation"] if reconcile else [])
+        self.connect_ring()
+        now = int(time.time())
+        for node in self.nodes:
+            node.setmocktime(now)
+
+        base_announcement_bytes = self.bytes_sent(ANNOUNCEMENT_MSGS)
+        base_inv_bytes = self.bytes_sent(["inv"])
+        txids = [self.wallet.send_self_transfer(from_node=self.nodes[0])["txid"] for _ in range(NUM_TXS)]
+
+        def relayed():
+            # Speed up trickling and reconciliation rounds.
+            for node in self.nodes:
+                node.bumpmocktime(1)
+            return all(set(txids) <= set(node.getrawmempool()) for node in self.nodes)
+        self.wait_until(relayed)
+        # Count the announcements still queued by then as well, such as floods
+        # of transactions the peer received elsewhere meanwhile.
+        for _ in range(SETTLE_TIME):
+            for node in self.nodes:
+                node.bumpmocktime(1)
+            time.sleep(0.1)
+
+        announcement_bytes = self.bytes_sent(ANNOUNCEMENT_MSGS) - base_announcement_bytes
+        inv_bytes = self.bytes_sent(["inv"]) - base_inv_bytes
+        reconciliation_bytes = self.bytes_sent(RECONCILIATION_MSGS)
+
+        # Confirm the transactions, so that they don't come back with the
+        # mempool on the next restart.
+        self.generate(self.nodes[0], 1)
+        self.wallet.rescan_utxos()
+        return announcement_bytes, inv_bytes, reconciliation_bytes
+
+    def restart_nodes(self, extra_args):
+        for i in range(self.num_nodes):
+            self.restart_node(i, extra_args=extra_args)
+
+    def run_test(self):
+        self.wallet = MiniWallet(self.nodes[0])
+
+        self.log.info("Relay transactions by flooding")
+        flood_bytes, flood_inv_bytes, flood_reconciliation_bytes = self.relay_transactions(reconcile=False)
+        assert_equal(flood_reconciliation_bytes, 0)
+        self.log.info(f"Flooding: {flood_bytes / NUM_TXS:.1f} announcement bytes per relayed transaction "
+                      f"({flood_inv_bytes / NUM_TXS:.1f} in inv messages)")
+
+        self.log.info("Relay transactions through reconciliation")
+        recon_bytes, recon_inv_bytes, reconciliation_bytes = self.relay_transactions(reconcile=True)
+        assert_greater_than(reconciliation_bytes, 0)
+        self.log.info(f"Reconciliation: {recon_bytes / NUM_TXS:.1f} announcement bytes per relayed transaction "
+                      f"({recon_inv_bytes / NUM_TXS:.1f} in inv messages, {reconciliation_bytes / NUM_TXS:.1f} in reconciliation messages)")
+
+        self.log.info("Check that reconciliation saves redundant inv announcements")
+        assert_greater_than(flood_inv_bytes, recon_inv_bytes * 1.1)
+
+        self.log.info("Check that reconciliation saves announcement bandwidth overall")
+        assert_greater_than(flood_bytes, recon_bytes)
+
+
+if __name__ == '__main__':
+    TxReconciliationTest(__file__).main()
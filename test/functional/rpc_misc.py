@@ -100,6 +100,13 @@ class RpcMiscTest(BitcoinTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test compactdatabase")
+        for database in ["chainstate", "blockindex", "txindex", "basic block filter index", "coinstatsindex"]:
+            with node.assert_debug_log([f"Finished database compaction of {node.chain_path}"]):
+                assert_equal(node.compactdatabase(database), None)
+        assert_equal(node.getindexinfo(), {"txindex": values, "basic block filter index": values, "coinstatsindex": values})
+        assert_raises_rpc_error(-8, "Unknown or disabled database: foo", node.compactdatabase, "foo")
+
 
 if __name__ == '__main__':
     RpcMiscTest(__file__).main()